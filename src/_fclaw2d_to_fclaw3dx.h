@@ -125,6 +125,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define fclaw2d_clawpatch_vt fclaw3dx_clawpatch_vt
 #define fclaw2d_clawpatch_vtable fclaw3dx_clawpatch_vtable
 #define fclaw2d_clawpatch_save_current_step fclaw3dx_clawpatch_save_current_step
+#define fclaw2d_clawpatch_tag_after_update fclaw3dx_clawpatch_tag_after_update
 #define fclaw2d_clawpatch_grid_data fclaw3dx_clawpatch_grid_data
 
 #if 0
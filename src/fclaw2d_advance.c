@@ -51,6 +51,24 @@ typedef struct fclaw2d_level_data
 /* Rather than over-loading operators ... */
 typedef fclaw2d_level_data_t fclaw2d_timestep_counters;
 
+/* Work on patches away from the parallel boundary that is postponed until
+   the ghost patch exchange has been started (overlap-ghost-exchange) */
+typedef struct fclaw2d_deferred_work
+{
+	int level;
+	int is_timeinterp;
+	double t;
+	double dt;
+	double alpha;
+} fclaw2d_deferred_work_t;
+
+typedef struct fclaw2d_overlap_data
+{
+	int count;
+	int size;
+	fclaw2d_deferred_work_t *work;
+} fclaw2d_overlap_data_t;
+
 static
 void initialize_timestep_counters(fclaw2d_global_t* glob,
 								  fclaw2d_timestep_counters **ts_counter_ptr,
@@ -173,15 +191,102 @@ double compute_alpha(fclaw2d_global_t *glob,
    Main time stepping routines
    ---------------------------------------------------------- */
 
+static
+fclaw2d_deferred_work_t* defer_work(fclaw2d_overlap_data_t *overlap)
+{
+	FCLAW_ASSERT(overlap->count < overlap->size);
+	return &overlap->work[overlap->count++];
+}
+
 static
 double update_level_solution(fclaw2d_global_t *glob,
 							 int level,
-							 double t, double dt)
+							 double t, double dt,
+							 fclaw2d_overlap_data_t *overlap)
+{
+	if (overlap == NULL)
+	{
+		/* There might not be any grids at this level */
+		return fclaw2d_update_single_step(glob,level,t,dt);
+	}
+
+	/* Only update patches needed for the ghost exchange now */
+	fclaw2d_deferred_work_t *w = defer_work(overlap);
+	w->level = level;
+	w->is_timeinterp = 0;
+	w->t = t;
+	w->dt = dt;
+	return fclaw2d_update_single_step_subset(glob,level,t,dt,
+											 FCLAW2D_BOUNDARY_GHOST_ONLY);
+}
+
+static
+void setup_timeinterp(fclaw2d_global_t *glob,
+					  int level, double alpha,
+					  fclaw2d_overlap_data_t *overlap)
+{
+	if (overlap == NULL)
+	{
+		fclaw2d_timeinterp(glob,level,alpha);
+		return;
+	}
+
+	fclaw2d_deferred_work_t *w = defer_work(overlap);
+	w->level = level;
+	w->is_timeinterp = 1;
+	w->alpha = alpha;
+	fclaw2d_timeinterp_subset(glob,level,alpha,FCLAW2D_BOUNDARY_GHOST_ONLY);
+}
+
+/* Finish postponed work, in the order it was postponed */
+static
+double finish_deferred_work(fclaw2d_global_t *glob,
+							fclaw2d_overlap_data_t *overlap)
+{
+	double maxcfl = 0;
+	int i;
+	for (i = 0; i < overlap->count; i++)
+	{
+		fclaw2d_deferred_work_t *w = &overlap->work[i];
+		if (w->is_timeinterp)
+		{
+			fclaw2d_timeinterp_subset(glob,w->level,w->alpha,
+									  FCLAW2D_BOUNDARY_INTERIOR_ONLY);
+		}
+		else
+		{
+			double cfl = fclaw2d_update_single_step_subset(glob,w->level,
+														   w->t,w->dt,
+														   FCLAW2D_BOUNDARY_INTERIOR_ONLY);
+			maxcfl = fmax(maxcfl,cfl);
+		}
+	}
+	overlap->count = 0;
+	return maxcfl;
+}
+
+/* Ghost update for all levels in [minlevel,maxlevel].  With overlap, the
+   postponed interior work is done while ghost patches are in transit.
+   Returns the max. CFL from postponed updates. */
+static
+double update_ghost(fclaw2d_global_t *glob,
+					fclaw2d_overlap_data_t *overlap,
+					int minlevel, int maxlevel,
+					double sync_time, int time_interp)
 {
-	/* There might not be any grids at this level */
-	double cfl = fclaw2d_update_single_step(glob,level,t,dt);
+	if (overlap == NULL)
+	{
+		fclaw2d_ghost_update(glob,minlevel,maxlevel,sync_time,
+							 time_interp,FCLAW2D_TIMER_ADVANCE);
+		return 0;
+	}
 
-	return cfl;
+	fclaw2d_ghost_update_begin(glob,minlevel,maxlevel,sync_time,
+							   time_interp,FCLAW2D_TIMER_ADVANCE);
+	double maxcfl = finish_deferred_work(glob,overlap);
+	fclaw2d_ghost_update_end(glob,minlevel,maxlevel,sync_time,
+							 time_interp,FCLAW2D_TIMER_ADVANCE);
+	return maxcfl;
 }
 
 static
@@ -189,7 +294,8 @@ double advance_level(fclaw2d_global_t *glob,
 					 const int level,
 					 const int curr_fine_step,
 					 double maxcfl,
-					 fclaw2d_timestep_counters* ts_counter)
+					 fclaw2d_timestep_counters* ts_counter,
+					 fclaw2d_overlap_data_t *overlap)
 {
 	fclaw2d_domain_t* domain = glob->domain;
 	const fclaw_options_t* fclaw_opt = fclaw2d_get_options(glob);
@@ -201,7 +307,8 @@ double advance_level(fclaw2d_global_t *glob,
 
 	fclaw_global_infof("Advancing level %d from step %d at time %12.6e\n",
 					   this_level,curr_fine_step,t_level);
-	double cfl_step = update_level_solution(glob,this_level,t_level,dt_level);
+	double cfl_step = update_level_solution(glob,this_level,t_level,dt_level,
+											overlap);
 	maxcfl = fmax(maxcfl,cfl_step);
 
 	fclaw_global_infof("------ Max CFL on level %d is %12.4e " \
@@ -218,7 +325,7 @@ double advance_level(fclaw2d_global_t *glob,
 		{
 			double cfl_step = advance_level(glob,coarser_level,
 											last_coarse_step,
-											maxcfl,ts_counter);
+											maxcfl,ts_counter,overlap);
 			maxcfl = fmax(maxcfl,cfl_step);
 			if (fclaw_opt->subcycle)
 			{
@@ -228,7 +335,7 @@ double advance_level(fclaw2d_global_t *glob,
 								   coarser_level,alpha);
 
 				fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_EXTRA1]);
-				fclaw2d_timeinterp(glob,coarser_level,alpha);
+				setup_timeinterp(glob,coarser_level,alpha,overlap);
 				fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_EXTRA1]);
 			}
 		}
@@ -264,6 +371,20 @@ double fclaw2d_advance_all_levels(fclaw2d_global_t *glob,
 	/* Keep track of largest cfl over all grid updates */
 	double maxcfl = 0;
 
+	/* Postpone updates of patches away from the parallel boundary until
+	   the ghost exchange has started.  Each level is updated at most once
+	   and time interpolated at most once between two ghost updates. */
+	fclaw2d_overlap_data_t overlap_data;
+	fclaw2d_overlap_data_t *overlap = NULL;
+	if (fclaw_opt->overlap_ghost_exchange)
+	{
+		overlap_data.count = 0;
+		overlap_data.size = 2*(maxlevel + 1);
+		overlap_data.work = FCLAW_ALLOC(fclaw2d_deferred_work_t,
+										overlap_data.size);
+		overlap = &overlap_data;
+	}
+
 	/* Step inc at maxlevel should be 1 by definition */
 	FCLAW_ASSERT(ts_counter[maxlevel].step_inc == 1);
 	int n_fine_steps = ts_counter[maxlevel].total_steps;
@@ -272,7 +393,8 @@ double fclaw2d_advance_all_levels(fclaw2d_global_t *glob,
 	{
 		/* Coarser levels get updated recursively */
 		/* Advance stores anything needed for later synchronization */
-		double cfl_step = advance_level(glob,maxlevel,nf,maxcfl,ts_counter);
+		double cfl_step = advance_level(glob,maxlevel,nf,maxcfl,ts_counter,
+										overlap);
 
 		maxcfl = fmax(cfl_step,maxcfl);
 		int last_step = ts_counter[maxlevel].last_step;
@@ -291,12 +413,12 @@ double fclaw2d_advance_all_levels(fclaw2d_global_t *glob,
 				int time_interp = 1;
 
 				/* Do conservative fix up here */
-				fclaw2d_ghost_update(glob,
-									 time_interp_level+1,
-									 maxlevel,
-									 sync_time,
-									 time_interp,
-									 FCLAW2D_TIMER_ADVANCE);
+				cfl_step = update_ghost(glob,overlap,
+										time_interp_level+1,
+										maxlevel,
+										sync_time,
+										time_interp);
+				maxcfl = fmax(cfl_step,maxcfl);
 				if (fclaw_opt->time_sync)
 			    {
 			    	fclaw2d_time_sync(glob,time_interp_level+1,maxlevel);
@@ -307,12 +429,12 @@ double fclaw2d_advance_all_levels(fclaw2d_global_t *glob,
 				/* End up here is we are doing global time stepping but return from 
 				   advance after 2^(maxlevel-minlevel) time steps. */
 				int time_interp = 0;
-				fclaw2d_ghost_update(glob,
-									 minlevel,
-									 maxlevel,
-									 sync_time,
-									 time_interp,
-									 FCLAW2D_TIMER_ADVANCE);
+				cfl_step = update_ghost(glob,overlap,
+										minlevel,
+										maxlevel,
+										sync_time,
+										time_interp);
+				maxcfl = fmax(cfl_step,maxcfl);
 				if (fclaw_opt->time_sync)
 			    {
 				    fclaw2d_time_sync(glob,minlevel,maxlevel);
@@ -331,8 +453,14 @@ double fclaw2d_advance_all_levels(fclaw2d_global_t *glob,
 
 	double sync_time =  ts_counter[maxlevel].current_time;
 	int time_interp = 0;
-	fclaw2d_ghost_update(glob,minlevel,maxlevel,sync_time,
-						 time_interp,FCLAW2D_TIMER_ADVANCE);
+	double cfl_step = update_ghost(glob,overlap,minlevel,maxlevel,sync_time,
+								   time_interp);
+	maxcfl = fmax(cfl_step,maxcfl);
+
+	if (overlap != NULL)
+	{
+		FCLAW_FREE(overlap->work);
+	}
 
 	if (fclaw_opt->time_sync)
 	{
@@ -27,12 +27,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef P4_TO_P8
 #include <fclaw2d_convenience.h>
 #include <p4est_bits.h>
+#include <p4est_extended.h>
 #include <p4est_search.h>
 #include <p4est_vtk.h>
 #include <p4est_wrap.h>
 #else
 #include <fclaw3d_convenience.h>
 #include <p8est_bits.h>
+#include <p8est_extended.h>
 #include <p8est_search.h>
 #include <p8est_vtk.h>
 #include <p8est_wrap.h>
@@ -678,6 +680,25 @@ fclaw2d_domain_adapt (fclaw2d_domain_t * domain)
     }
 }
 
+static fclaw2d_domain_t *
+fclaw2d_domain_new_partitioned (fclaw2d_domain_t * domain,
+                                p4est_locidx_t uf, p4est_locidx_t ul,
+                                p4est_locidx_t uof)
+{
+    p4est_wrap_t *wrap = (p4est_wrap_t *) domain->pp;
+    fclaw2d_domain_t *newd;
+
+    domain->pp_owned = 0;
+    newd = fclaw2d_domain_new (wrap, domain->attributes);
+    newd->just_partitioned = 1;
+    newd->partition_unchanged_first = (int) uf;
+    newd->partition_unchanged_length = (int) ul;
+    newd->partition_unchanged_old_first = (int) uof;
+
+    fclaw2d_domain_copy_parameters (newd, domain);
+    return newd;
+}
+
 fclaw2d_domain_t *
 fclaw2d_domain_partition (fclaw2d_domain_t * domain, int weight_exponent)
 {
@@ -691,17 +712,7 @@ fclaw2d_domain_partition (fclaw2d_domain_t * domain, int weight_exponent)
     domain->just_adapted = 0;
     if (p4est_wrap_partition (wrap, weight_exponent, &uf, &ul, &uof))
     {
-        fclaw2d_domain_t *newd;
-
-        domain->pp_owned = 0;
-        newd = fclaw2d_domain_new (wrap, domain->attributes);
-        newd->just_partitioned = 1;
-        newd->partition_unchanged_first = (int) uf;
-        newd->partition_unchanged_length = (int) ul;
-        newd->partition_unchanged_old_first = (int) uof;
-
-        fclaw2d_domain_copy_parameters (newd, domain);
-        return newd;
+        return fclaw2d_domain_new_partitioned (domain, uf, ul, uof);
     }
     else
     {
@@ -709,6 +720,129 @@ fclaw2d_domain_partition (fclaw2d_domain_t * domain, int weight_exponent)
     }
 }
 
+typedef struct fclaw2d_domain_weight
+{
+    fclaw2d_domain_t *domain;
+    fclaw2d_weight_callback_t wcb;
+    void *user;
+}
+fclaw2d_domain_weight_t;
+
+static int
+fclaw2d_domain_partition_weight (p4est_t * p4est, p4est_topidx_t which_tree,
+                                 p4est_quadrant_t * quadrant)
+{
+    fclaw2d_domain_weight_t *dw =
+        (fclaw2d_domain_weight_t *) p4est->user_pointer;
+    p4est_tree_t *tree = p4est_tree_array_index (p4est->trees, which_tree);
+    int patchno = (int) (quadrant - p4est_quadrant_array_index
+                         (&tree->quadrants, 0));
+    fclaw2d_block_t *block = dw->domain->blocks + which_tree;
+    int weight;
+
+    FCLAW_ASSERT (0 <= patchno && patchno < block->num_patches);
+    weight = dw->wcb (dw->domain, block->patches + patchno,
+                      (int) which_tree, patchno, dw->user);
+    FCLAW_ASSERT (weight >= 0);
+    return weight;
+}
+
+/* The adapted ghost layer and mesh become the current ones, as at the
+   end of p4est_wrap_partition when the partition does not change.
+   The wrap then expects the next adapt, not p4est_wrap_complete. */
+static void
+fclaw2d_wrap_keep_partition (p4est_wrap_t * wrap)
+{
+    memset (wrap->flags, 0,
+            sizeof (uint8_t) * wrap->p4est->local_num_quadrants);
+    wrap->ghost = wrap->ghost_aux;
+    wrap->mesh = wrap->mesh_aux;
+    wrap->ghost_aux = NULL;
+    wrap->mesh_aux = NULL;
+    wrap->match_aux = 0;
+}
+
+fclaw2d_domain_t *
+fclaw2d_domain_partition_weighted (fclaw2d_domain_t * domain,
+                                   fclaw2d_weight_callback_t wcb, void *user)
+{
+    p4est_wrap_t *wrap = (p4est_wrap_t *) domain->pp;
+    p4est_t *p4est = wrap->p4est;
+    p4est_gloidx_t pre_me, pre_next, post_me, post_next;
+    p4est_locidx_t uf, ul, uof;
+    fclaw2d_domain_weight_t dw;
+    void *user_pointer;
+    int changed;
+
+    FCLAW_ASSERT (domain->pp_owned);
+    FCLAW_ASSERT (domain->just_adapted);
+    FCLAW_ASSERT (!domain->just_partitioned);
+    FCLAW_ASSERT (wrap->match_aux);
+    FCLAW_ASSERT (wcb != NULL);
+
+    /* p4est_wrap_partition only weighs patches by level.  These are its
+       steps, with the weights of the caller passed to p4est_partition_ext. */
+    domain->just_adapted = 0;
+    p4est_mesh_destroy (wrap->mesh);
+    p4est_ghost_destroy (wrap->ghost);
+    wrap->match_aux = 0;
+
+    pre_me = p4est->global_first_quadrant[p4est->mpirank];
+    pre_next = p4est->global_first_quadrant[p4est->mpirank + 1];
+
+    /* The weight callback finds the domain through the user pointer.
+       As in p4est_wrap_partition, the partition is for coarsening, which
+       keeps families on one process. */
+    dw.domain = domain;
+    dw.wcb = wcb;
+    dw.user = user;
+    user_pointer = p4est->user_pointer;
+    p4est->user_pointer = &dw;
+    changed = p4est_partition_ext (p4est, 1,
+                                   fclaw2d_domain_partition_weight) > 0;
+    p4est->user_pointer = user_pointer;
+
+    if (!changed)
+    {
+        fclaw2d_wrap_keep_partition (wrap);
+        return NULL;
+    }
+
+    P4EST_FREE (wrap->flags);
+    wrap->flags = P4EST_ALLOC_ZERO (uint8_t, p4est->local_num_quadrants);
+    wrap->ghost = p4est_ghost_new (p4est, wrap->btype);
+    wrap->mesh = p4est_mesh_new_ext (p4est, wrap->ghost, 1, 1, wrap->btype);
+
+    /* Window of patches that stayed on this process */
+    post_me = p4est->global_first_quadrant[p4est->mpirank];
+    post_next = p4est->global_first_quadrant[p4est->mpirank + 1];
+    uf = uof = ul = 0;
+    if (pre_me < post_next && post_me < pre_next)
+    {
+        uf = post_me < pre_me ? (p4est_locidx_t) (pre_me - post_me) : 0;
+        uof = pre_me < post_me ? (p4est_locidx_t) (post_me - pre_me) : 0;
+        ul = (p4est_locidx_t) (SC_MIN (pre_next, post_next) -
+                               SC_MAX (pre_me, post_me));
+    }
+    return fclaw2d_domain_new_partitioned (domain, uf, ul, uof);
+}
+
+void
+fclaw2d_domain_keep_partition (fclaw2d_domain_t * domain)
+{
+    p4est_wrap_t *wrap = (p4est_wrap_t *) domain->pp;
+
+    FCLAW_ASSERT (domain->pp_owned);
+    FCLAW_ASSERT (domain->just_adapted);
+    FCLAW_ASSERT (!domain->just_partitioned);
+    FCLAW_ASSERT (wrap->match_aux);
+
+    domain->just_adapted = 0;
+    p4est_mesh_destroy (wrap->mesh);
+    p4est_ghost_destroy (wrap->ghost);
+    fclaw2d_wrap_keep_partition (wrap);
+}
+
 void
 fclaw2d_domain_partition_unchanged (fclaw2d_domain_t * domain,
                                     int *unchanged_first,
@@ -123,6 +123,46 @@ fclaw2d_domain_t *fclaw2d_domain_adapt (fclaw2d_domain_t * domain);
 fclaw2d_domain_t *fclaw2d_domain_partition (fclaw2d_domain_t * domain,
                                             int weight_exponent);
 
+/** Callback returning the partition weight of a local patch.
+ * \param [in] domain           Domain before partition.
+ * \param [in] patch            The patch to weigh.
+ * \param [in] blockno          Block number of the patch.
+ * \param [in] patchno          Patch number within the block.
+ * \param [in] user             Pointer passed through.
+ * \return                      Weight of the patch, non-negative.
+ *                              The sum over all patches of all processes
+ *                              must fit into a 64-bit integer.
+ */
+typedef int (*fclaw2d_weight_callback_t) (fclaw2d_domain_t * domain,
+                                          fclaw2d_patch_t * patch,
+                                          int blockno, int patchno,
+                                          void *user);
+
+/** Create a repartitioned domain after fclaw2d_domain_adapt returned non-NULL,
+ * with patch weights given by a callback instead of by level.
+ * All refine and coarsen markers are cancelled when this function is done.
+ * \param [in,out] domain       Current domain that was adapted previously.
+ *                              It stays alive because it is needed to
+ *                              transfer numerical values to the new partition.
+ *                              If partitioned, no queries allowed afterwards.
+ * \param [in] wcb              Called once for each local patch.
+ * \param [in] user             Pointer passed to \a wcb.
+ * \return                      Partitioned domain if different, or NULL.
+ *                              The return status is identical across all ranks.
+ */
+fclaw2d_domain_t *fclaw2d_domain_partition_weighted (fclaw2d_domain_t * domain,
+                                                     fclaw2d_weight_callback_t
+                                                     wcb, void *user);
+
+/** Finish an adapt without partitioning, after fclaw2d_domain_adapt
+ * returned non-NULL.  The domain keeps its patches and stays valid,
+ * and the next call may be fclaw2d_domain_adapt again.
+ * All refine and coarsen markers are cancelled when this function is done.
+ * It must be called on all ranks, in place of the partition.
+ * \param [in,out] domain       Current domain that was adapted previously.
+ */
+void fclaw2d_domain_keep_partition (fclaw2d_domain_t * domain);
+
 /** Query the window of patches that is not transferred on partition.
  * \param [in] domain           A domain after a non-trivial partition
  *                              and before calling \ref fclaw2d_domain_complete.
@@ -131,19 +131,17 @@ static
 void get_corner_neighbor(fclaw2d_global_t *glob,
                          int this_block_idx,
                          int this_patch_idx,
-                         fclaw2d_patch_t* this_patch,
                          int icorner,
-                         int block_iface,
-                         int is_block_corner,
-                         int *corner_block_idx,
-                         fclaw2d_patch_t** corner_patch,
-                         int *rcornerno,
-                         int **ref_flag_ptr,
-                         int *block_corner_count,
-                         int ftransform[],
-                         fclaw2d_patch_transform_data_t* ftransform_finegrid)
+                         fclaw2d_ghost_fill_corner_plan_t *cplan)
 {
     fclaw2d_domain_t *domain = glob->domain;
+    int block_iface = cplan->block_iface;
+    int is_block_corner = cplan->is_block_corner;
+    int *corner_block_idx = &cplan->corner_block_idx;
+    int *rcornerno = &cplan->rcornerno;
+    int *block_corner_count = &cplan->block_corner_count;
+    int *ftransform = cplan->transform;
+    int *ftransform_finegrid = cplan->transform_finegrid;
     /* See what p4est thinks we have for corners, and consider four cases */
     int rproc_corner;
     int corner_patch_idx;
@@ -167,6 +165,10 @@ void get_corner_neighbor(fclaw2d_global_t *glob,
     fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_NEIGHBOR_SEARCH]);    
 
     *block_corner_count = 0;  /* Assume we are not at a block corner */
+    cplan->has_neighbor = 1;
+    cplan->has_transform = 0;
+    cplan->block_iface_finegrid = -1;
+    cplan->corner_patch = NULL;
     if (has_corner_neighbor && is_block_corner)
     {
         /* Case 1 : 4 or more patches meet at a block corner.
@@ -177,14 +179,14 @@ void get_corner_neighbor(fclaw2d_global_t *glob,
         interior 'default' transforms. */
         fclaw2d_patch_transform_blockface_intra (glob, ftransform);
         fclaw2d_patch_transform_blockface_intra
-            (glob, ftransform_finegrid->transform);
+            (glob, ftransform_finegrid);
+        cplan->has_transform = 1;
     }
     else if (!has_corner_neighbor && !is_block_corner)
     {
         /* Case 2 : 'icorner' is a hanging node */
         /* We do not return valid transformation objects! */
-        *ref_flag_ptr = NULL;
-        *corner_patch = NULL;
+        cplan->has_neighbor = 0;
         return;
     }
     else if (has_corner_neighbor && !is_block_corner)
@@ -224,8 +226,9 @@ void get_corner_neighbor(fclaw2d_global_t *glob,
             int rface1 = rfaceno;
             fclaw2d_patch_face_swap(&iface1,&rface1);
             fclaw2d_patch_transform_blockface(glob, iface1, rface1,
-                                              ftransform_finegrid->transform);
-            ftransform_finegrid->block_iface = iface1;
+                                              ftransform_finegrid);
+            cplan->block_iface_finegrid = iface1;
+            cplan->has_transform = 1;
         }
         else if (this_block_idx == *corner_block_idx)
         {
@@ -234,8 +237,8 @@ void get_corner_neighbor(fclaw2d_global_t *glob,
             *block_corner_count = 4;  /* assume four for now */
             fclaw2d_patch_transform_blockface_intra (glob, ftransform);
             fclaw2d_patch_transform_blockface_intra
-                (glob, ftransform_finegrid->transform);
-
+                (glob, ftransform_finegrid);
+            cplan->has_transform = 1;
         }
         else
         {
@@ -256,8 +259,7 @@ void get_corner_neighbor(fclaw2d_global_t *glob,
             /* Exactly 3 patches meet at a corner, e.g. the cubed sphere.
                In this case, 'this_patch' has no corner-adjacent only
                neighbors, and so there is nothing to do. */
-            *ref_flag_ptr = NULL;
-            *corner_patch = NULL;
+            cplan->has_neighbor = 0;
             return;
         }
         else
@@ -307,28 +309,69 @@ void get_corner_neighbor(fclaw2d_global_t *glob,
 
     if (domain->mpirank != rproc_corner)
     {
-        *corner_patch = &domain->ghost_patches[corner_patch_idx];
+        cplan->corner_patch = &domain->ghost_patches[corner_patch_idx];
     }
     else
     {
         fclaw2d_block_t *neighbor_block = &domain->blocks[*corner_block_idx];
-        *corner_patch = &neighbor_block->patches[corner_patch_idx];
+        cplan->corner_patch = &neighbor_block->patches[corner_patch_idx];
     }
 
     if (neighbor_type == FCLAW2D_PATCH_HALFSIZE)
     {
-        **ref_flag_ptr = 1;
+        cplan->neighbor_level = FINER_GRID;
     }
     else if (neighbor_type == FCLAW2D_PATCH_SAMESIZE)
     {
-        **ref_flag_ptr = 0;
+        cplan->neighbor_level = SAMESIZE_GRID;
     }
     else /* FCLAW2D_PATCH_DOUBLESIZE */
     {
-        **ref_flag_ptr = -1;
+        cplan->neighbor_level = COARSER_GRID;
     }
 }
 
+void fclaw2d_corner_neighbors_plan(fclaw2d_global_t *glob,
+                                   fclaw2d_patch_t *this_patch,
+                                   int this_block_idx,
+                                   int this_patch_idx,
+                                   fclaw2d_ghost_fill_corner_plan_t *corner_plan)
+{
+    int intersects_bdry[FCLAW2D_NUMFACES];
+    int intersects_block[FCLAW2D_NUMFACES];
+    int icorner;
+
+    fclaw2d_physical_get_bc(glob,this_block_idx,this_patch_idx,
+                            intersects_bdry);
+
+    fclaw2d_block_get_block_boundary(glob, this_patch, intersects_block);
+
+    for (icorner = 0; icorner < FCLAW2D_NUMCORNERS; icorner++)
+    {
+        fclaw2d_ghost_fill_corner_plan_t *cplan = &corner_plan[icorner];
+        get_corner_type(glob,icorner,
+                        intersects_bdry,
+                        intersects_block,
+                        &cplan->is_interior_corner,
+                        &cplan->is_block_corner,
+                        &cplan->block_iface);
+
+        cplan->has_neighbor = 0;
+        cplan->block_corner_count = 0;
+        if (cplan->is_interior_corner)
+        {
+            cplan->corner_block_idx = -1;
+            get_corner_neighbor(glob,
+                                this_block_idx,
+                                this_patch_idx,
+                                icorner,
+                                cplan);
+        }
+    }
+}
+
+
+
 
 
 void cb_corner_fill(fclaw2d_domain_t *domain,
@@ -350,18 +393,27 @@ void cb_corner_fill(fclaw2d_domain_t *domain,
     int average_from_neighbor = filltype->exchange_type == FCLAW2D_AVERAGE;
     int interpolate_to_neighbor = filltype->exchange_type == FCLAW2D_INTERPOLATE;
 
-    int intersects_bdry[FCLAW2D_NUMFACES];
-    int intersects_block[FCLAW2D_NUMFACES];
-    int is_block_corner;
-    int is_interior_corner;
-    int block_corner_count;
-
     int icorner;
 
-    fclaw2d_physical_get_bc(s->glob,this_block_idx,this_patch_idx,
-                            intersects_bdry);
-
-    fclaw2d_block_get_block_boundary(s->glob, this_patch, intersects_block);
+    /* Use neighbor information cached at the last regrid if we have it;
+       otherwise search for the neighbors now. */
+    fclaw2d_ghost_fill_corner_plan_t corner_plan_local[FCLAW2D_NUMCORNERS];
+    fclaw2d_ghost_fill_corner_plan_t *corner_plan;
+    fclaw2d_ghost_fill_plan_t *plan = fclaw2d_ghost_fill_plan_get(domain);
+    if (plan != NULL)
+    {
+        int patch_num = domain->blocks[this_block_idx].num_patches_before
+                        + this_patch_idx;
+        FCLAW_ASSERT(0 <= patch_num && patch_num < plan->num_patches);
+        corner_plan = &plan->corners[FCLAW2D_NUMCORNERS*patch_num];
+    }
+    else
+    {
+        fclaw2d_corner_neighbors_plan(s->glob,this_patch,
+                                      this_block_idx,this_patch_idx,
+                                      corner_plan_local);
+        corner_plan = corner_plan_local;
+    }
 
     /* Transform data needed at multi-block boundaries */
     fclaw2d_patch_transform_data_t transform_data;
@@ -388,60 +440,49 @@ void cb_corner_fill(fclaw2d_domain_t *domain,
 
     for (icorner = 0; icorner < FCLAW2D_NUMCORNERS; icorner++)
     {
-        block_corner_count = 0;
-        get_corner_type(s->glob,icorner,
-                        intersects_bdry,
-                        intersects_block,
-                        &is_interior_corner,
-                        &is_block_corner,
-                        &transform_data.block_iface);
+        const fclaw2d_ghost_fill_corner_plan_t *cplan = &corner_plan[icorner];
+        int is_block_corner = cplan->is_block_corner;
 
+        transform_data.block_iface = cplan->block_iface;
         transform_data_finegrid.block_iface = -1;
 
         /* Sets block_corner_count to 0 */
         fclaw2d_patch_set_block_corner_count(s->glob, this_patch,
-                                             icorner,block_corner_count);
+                                             icorner,0);
 
-        if (is_interior_corner)
+        if (cplan->is_interior_corner)
         {
             /* Is an interior patch corner;  may also be a block corner */
 
-            int corner_block_idx;
-            int neighbor_level;
-            int *ref_flag_ptr = &neighbor_level;
-            fclaw2d_patch_t *corner_patch;
-            int rcornerno;
+            int corner_block_idx = cplan->corner_block_idx;
+            int neighbor_level = cplan->neighbor_level;
+            fclaw2d_patch_t *corner_patch = cplan->corner_patch;
 
             transform_data.icorner = icorner;
-            corner_block_idx = -1;
-            get_corner_neighbor(s->glob,
-                                this_block_idx,
-                                this_patch_idx,
-                                this_patch,
-                                icorner,
-                                transform_data.block_iface,
-                                is_block_corner,
-                                &corner_block_idx,
-                                &corner_patch,
-                                &rcornerno,
-                                &ref_flag_ptr,
-                                &block_corner_count,
-                                transform_data.transform,
-                                &transform_data_finegrid);
+            if (cplan->has_transform)
+            {
+                /* Transforms are not set in every case (see
+                   get_corner_neighbor) */
+                memcpy(transform_data.transform,cplan->transform,
+                       sizeof(transform_data.transform));
+                memcpy(transform_data_finegrid.transform,cplan->transform_finegrid,
+                       sizeof(transform_data_finegrid.transform));
+                transform_data_finegrid.block_iface = cplan->block_iface_finegrid;
+            }
 
             /* This sets value in block_corner_count_array */
             fclaw2d_patch_set_block_corner_count(s->glob, this_patch,
-                                                 icorner,block_corner_count);
+                                                 icorner,cplan->block_corner_count);
             transform_data.is_block_corner = is_block_corner;
 
             /* Needed for switching the context */
             transform_data_finegrid.is_block_corner = is_block_corner;
-            transform_data_finegrid.icorner = rcornerno;
+            transform_data_finegrid.icorner = cplan->rcornerno;
             transform_data_finegrid.this_patch = corner_patch;
             transform_data_finegrid.neighbor_patch = this_patch;
 
 
-            if (ref_flag_ptr == NULL)
+            if (!cplan->has_neighbor)
             {
                 /* No corner neighbor.  Either :
                    -- Hanging node
@@ -30,6 +30,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <fclaw2d_patch.h>
 #include <fclaw2d_exchange.h>
 #include <fclaw2d_global.h>
+#include <fclaw2d_ghost_fill.h>
 #else
 #include <fclaw3d_domain.h>
 #include <fclaw3d_convenience.h>  /* Contains domain_destroy and others */
@@ -38,6 +39,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <fclaw3d_global.h>
 #endif
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 /* dimension-independent helper functions first */
 
 #if 0
@@ -183,12 +188,25 @@ void fclaw2d_domain_data_new(fclaw2d_domain_t *domain)
     
     ddata->domain_exchange = NULL;
     ddata->domain_indirect = NULL;
+    ddata->exchange_num_levels = 0;
+    ddata->exchange_level_offset = NULL;
+    ddata->exchange_level_index = NULL;
+    ddata->exchange_level_patches = NULL;
+    ddata->ghost_level_offset = NULL;
+    ddata->ghost_level_index = NULL;
+    ddata->partition_kept = NULL;
+#ifndef P4_TO_P8
+    ddata->ghost_fill_plan = NULL;
+#endif
 }
 
 void fclaw2d_domain_data_delete(fclaw2d_domain_t* domain)
 {
     fclaw2d_domain_data_t* ddata = (fclaw2d_domain_data_t*) domain->user;
 
+#ifndef P4_TO_P8
+    fclaw2d_ghost_fill_plan_destroy(domain);
+#endif
     FCLAW_FREE (ddata);
     domain->user = NULL;
 }
@@ -258,27 +276,63 @@ void fclaw2d_domain_reset(fclaw2d_global_t* glob)
     *domain = NULL;
 }
 
-void fclaw2d_domain_iterate_level_mthread (fclaw2d_domain_t * domain, int level,
-                                           fclaw2d_patch_callback_t pcb, void *user)
+/* Collect the (block, patch) pairs of a level into a single list, so that
+   threads are not synchronized at every block boundary.  A negative level
+   collects the patches of all levels.  If mask is not NULL, only patches
+   with mask[local patch index] == mask_value are kept.
+   Returns the number of pairs stored in list. */
+static int
+domain_level_list (fclaw2d_domain_t * domain, int level,
+                   const int *mask, int mask_value, int **list)
 {
-#if (_OPENMP)
     int i, j;
-    fclaw2d_block_t *block;
-    fclaw2d_patch_t *patch;
+    int count = 0;
 
+    *list = FCLAW_ALLOC (int, 2 * domain->local_num_patches);
     for (i = 0; i < domain->num_blocks; i++)
     {
-        block = domain->blocks + i;
-#pragma omp parallel for private(patch,j)
+        fclaw2d_block_t *block = domain->blocks + i;
+        if (level >= 0 &&
+            (level < block->minlevel || level > block->maxlevel))
+        {
+            continue;
+        }
         for (j = 0; j < block->num_patches; j++)
         {
-            patch = block->patches + j;
-            if (patch->level == level)
+            if ((level < 0 || block->patches[j].level == level) &&
+                (mask == NULL ||
+                 mask[block->num_patches_before + j] == mask_value))
             {
-                pcb (domain, patch, i, j, user);
+                (*list)[2 * count] = i;
+                (*list)[2 * count + 1] = j;
+                count++;
             }
         }
     }
+    return count;
+}
+
+void fclaw2d_domain_iterate_level_mthread (fclaw2d_domain_t * domain, int level,
+                                           fclaw2d_patch_callback_t pcb, void *user)
+{
+#if (_OPENMP)
+    int k, count;
+    int *list;
+
+    count = domain_level_list (domain, level, NULL, 0, &list);
+
+    /* Patches are handed out one at a time, so threads that finish early
+       pick up work from any block. */
+#pragma omp parallel for schedule(dynamic)
+    for (k = 0; k < count; k++)
+    {
+        int blockno = list[2 * k];
+        int patchno = list[2 * k + 1];
+        fclaw2d_patch_t *patch = domain->blocks[blockno].patches + patchno;
+        pcb (domain, patch, blockno, patchno, user);
+    }
+
+    FCLAW_FREE (list);
 #else
 #ifndef P4_TO_P8
     fclaw_global_essentialf("fclaw2d_patch_iterator_mthread: We should not be here\n");
@@ -287,3 +341,279 @@ void fclaw2d_domain_iterate_level_mthread (fclaw2d_domain_t * domain, int level,
 #endif
 #endif
 }
+
+void fclaw2d_domain_iterate_patches_mthread (fclaw2d_domain_t * domain,
+                                             fclaw2d_patch_callback_t pcb,
+                                             void *user)
+{
+#if (_OPENMP)
+    int k, count;
+    int *list;
+
+    count = domain_level_list (domain, -1, NULL, 0, &list);
+
+#pragma omp parallel for schedule(dynamic)
+    for (k = 0; k < count; k++)
+    {
+        int blockno = list[2 * k];
+        int patchno = list[2 * k + 1];
+        fclaw2d_patch_t *patch = domain->blocks[blockno].patches + patchno;
+        pcb (domain, patch, blockno, patchno, user);
+    }
+
+    FCLAW_FREE (list);
+#else
+    fclaw2d_domain_iterate_patches (domain, pcb, user);
+#endif
+}
+
+#if (_OPENMP)
+
+/* One call of an adapted or partitioned iteration.  old_patchno is -1 for
+   patches received in a partition. */
+typedef struct domain_match
+{
+    int blockno;
+    int old_patchno;
+    int new_patchno;
+    fclaw2d_patch_relation_t newsize;
+}
+domain_match_t;
+
+typedef struct domain_match_list
+{
+    domain_match_t *matches;
+    int count;
+}
+domain_match_list_t;
+
+static void
+domain_record_match (domain_match_list_t * ml, int blockno,
+                     int old_patchno, int new_patchno,
+                     fclaw2d_patch_relation_t newsize)
+{
+    domain_match_t *m = ml->matches + ml->count++;
+    m->blockno = blockno;
+    m->old_patchno = old_patchno;
+    m->new_patchno = new_patchno;
+    m->newsize = newsize;
+}
+
+static void
+domain_record_adapted (fclaw2d_domain_t * old_domain,
+                       fclaw2d_patch_t * old_patch,
+                       fclaw2d_domain_t * new_domain,
+                       fclaw2d_patch_t * new_patch,
+                       fclaw2d_patch_relation_t newsize, int blockno,
+                       int old_patchno, int new_patchno, void *user)
+{
+    domain_record_match ((domain_match_list_t *) user, blockno,
+                         old_patchno, new_patchno, newsize);
+}
+
+static void
+domain_record_partitioned (fclaw2d_domain_t * old_domain,
+                           fclaw2d_patch_t * old_patch,
+                           fclaw2d_domain_t * new_domain,
+                           fclaw2d_patch_t * new_patch, int blockno,
+                           int old_patchno, int new_patchno, void *user)
+{
+    domain_record_match ((domain_match_list_t *) user, blockno,
+                         old_patchno, new_patchno, FCLAW2D_PATCH_SAMESIZE);
+}
+
+#endif
+
+/* The matching of old and new patches is cheap but sequential, so it is
+   done by the serial iterators.  The callbacks, which build and copy patch
+   data, are then handed out to threads. */
+void fclaw2d_domain_iterate_adapted_mthread (fclaw2d_domain_t * old_domain,
+                                             fclaw2d_domain_t * new_domain,
+                                             fclaw2d_match_callback_t mcb,
+                                             void *user)
+{
+#if (_OPENMP)
+    int k;
+    domain_match_list_t ml;
+
+    /* Every match consumes at least one new patch */
+    ml.matches = FCLAW_ALLOC (domain_match_t, new_domain->local_num_patches);
+    ml.count = 0;
+    fclaw2d_domain_iterate_adapted (old_domain, new_domain,
+                                    domain_record_adapted, &ml);
+
+#pragma omp parallel for schedule(dynamic)
+    for (k = 0; k < ml.count; k++)
+    {
+        const domain_match_t *m = ml.matches + k;
+        fclaw2d_patch_t *old_patch =
+            old_domain->blocks[m->blockno].patches + m->old_patchno;
+        fclaw2d_patch_t *new_patch =
+            new_domain->blocks[m->blockno].patches + m->new_patchno;
+        mcb (old_domain, old_patch, new_domain, new_patch, m->newsize,
+             m->blockno, m->old_patchno, m->new_patchno, user);
+    }
+
+    FCLAW_FREE (ml.matches);
+#else
+    fclaw2d_domain_iterate_adapted (old_domain, new_domain, mcb, user);
+#endif
+}
+
+void fclaw2d_domain_iterate_partitioned_mthread (fclaw2d_domain_t * old_domain,
+                                                 fclaw2d_domain_t * new_domain,
+                                                 fclaw2d_transfer_callback_t tcb,
+                                                 void *user)
+{
+#if (_OPENMP)
+    int k;
+    domain_match_list_t ml;
+
+    ml.matches = FCLAW_ALLOC (domain_match_t, new_domain->local_num_patches);
+    ml.count = 0;
+    fclaw2d_domain_iterate_partitioned (old_domain, new_domain,
+                                        domain_record_partitioned, &ml);
+    FCLAW_ASSERT (ml.count == new_domain->local_num_patches);
+
+#pragma omp parallel for schedule(dynamic)
+    for (k = 0; k < ml.count; k++)
+    {
+        const domain_match_t *m = ml.matches + k;
+        fclaw2d_patch_t *old_patch = m->old_patchno < 0 ? NULL :
+            old_domain->blocks[m->blockno].patches + m->old_patchno;
+        fclaw2d_patch_t *new_patch =
+            new_domain->blocks[m->blockno].patches + m->new_patchno;
+        tcb (old_domain, old_patch, new_domain, new_patch,
+             m->blockno, m->old_patchno, m->new_patchno, user);
+    }
+
+    FCLAW_FREE (ml.matches);
+#else
+    fclaw2d_domain_iterate_partitioned (old_domain, new_domain, tcb, user);
+#endif
+}
+
+/* Process one batch of consecutive entries of the level list.  Exactly one
+   of rcb and bcb is non-NULL. */
+static void
+domain_level_batch (fclaw2d_domain_t * domain, const int *list, int count,
+                    int ibatch, int batch_size,
+                    fclaw2d_patch_reduce_callback_t rcb,
+                    fclaw2d_patch_batch_callback_t bcb,
+                    void *local, void *user)
+{
+    int k;
+    int first = ibatch * batch_size;
+    int last = SC_MIN (first + batch_size, count);
+
+    for (k = first; k < last; k++)
+    {
+        int blockno = list[2 * k];
+        int patchno = list[2 * k + 1];
+        fclaw2d_patch_t *patch = domain->blocks[blockno].patches + patchno;
+        if (rcb != NULL)
+        {
+            rcb (domain, patch, blockno, patchno, local, user);
+        }
+        else
+        {
+            bcb (domain, patch, blockno, patchno, k - first, last - first,
+                 local, user);
+        }
+    }
+}
+
+/* Shared driver for the reduction iterators.  Batches are handed out to
+   threads dynamically;  every batch is processed by a single thread. */
+static void
+domain_iterate_level_batches (fclaw2d_domain_t * domain, int level,
+                              int batch_size,
+                              const int *patch_mask, int mask_value,
+                              fclaw2d_patch_reduce_callback_t rcb,
+                              fclaw2d_patch_batch_callback_t bcb,
+                              void *user, void *result, size_t result_size,
+                              fclaw2d_reduce_combine_t combine)
+{
+    int ibatch, t, count, num_batches;
+    int *list;
+    int num_threads = 1;
+    size_t stride;
+    char *locals;
+
+    FCLAW_ASSERT ((rcb == NULL) != (bcb == NULL));
+
+#if (_OPENMP)
+    num_threads = omp_get_max_threads ();
+#endif
+
+    count = domain_level_list (domain, level, patch_mask, mask_value, &list);
+    if (batch_size <= 0)
+    {
+        /* A single batch, or a few per thread so the load can still be
+           balanced */
+        int num_batches = num_threads == 1 ? 1 : 4 * num_threads;
+        batch_size = SC_MAX ((count + num_batches - 1) / num_batches, 1);
+    }
+    num_batches = (count + batch_size - 1) / batch_size;
+
+    /* One accumulator per thread, each on its own cache line(s) and
+       initialized with the identity passed in through result. */
+    stride = ((result_size + 63) / 64) * 64;
+    locals = FCLAW_ALLOC (char, stride * num_threads);
+    for (t = 0; t < num_threads; t++)
+    {
+        memcpy (locals + t * stride, result, result_size);
+    }
+
+#if (_OPENMP)
+#pragma omp parallel num_threads(num_threads)
+    {
+        void *local = locals + stride * omp_get_thread_num ();
+#pragma omp for schedule(dynamic)
+        for (ibatch = 0; ibatch < num_batches; ibatch++)
+        {
+            domain_level_batch (domain, list, count, ibatch, batch_size,
+                                rcb, bcb, local, user);
+        }
+    }
+#else
+    for (ibatch = 0; ibatch < num_batches; ibatch++)
+    {
+        domain_level_batch (domain, list, count, ibatch, batch_size,
+                            rcb, bcb, locals, user);
+    }
+#endif
+
+    /* Merge serially, in thread order, so results are reproducible */
+    for (t = 0; t < num_threads; t++)
+    {
+        combine (result, locals + t * stride);
+    }
+
+    FCLAW_FREE (locals);
+    FCLAW_FREE (list);
+}
+
+void fclaw2d_domain_iterate_level_reduce (fclaw2d_domain_t * domain, int level,
+                                          fclaw2d_patch_reduce_callback_t pcb,
+                                          void *user, void *result,
+                                          size_t result_size,
+                                          fclaw2d_reduce_combine_t combine)
+{
+    domain_iterate_level_batches (domain, level, 1, NULL, 0, pcb, NULL, user,
+                                  result, result_size, combine);
+}
+
+void fclaw2d_domain_iterate_level_batched (fclaw2d_domain_t * domain,
+                                           int level, int batch_size,
+                                           const int *patch_mask,
+                                           int mask_value,
+                                           fclaw2d_patch_batch_callback_t pcb,
+                                           void *user, void *result,
+                                           size_t result_size,
+                                           fclaw2d_reduce_combine_t combine)
+{
+    domain_iterate_level_batches (domain, level, batch_size,
+                                  patch_mask, mask_value, NULL, pcb, user,
+                                  result, result_size, combine);
+}
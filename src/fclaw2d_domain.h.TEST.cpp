@@ -0,0 +1,305 @@
+/*
+Copyright (c) 2012-2023 Carsten Burstedde, Donna Calhoun, Scott Aiton
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <fclaw2d_convenience.h>
+#include <fclaw2d_domain.h>
+#include <test.hpp>
+
+#include <vector>
+
+namespace
+{
+
+struct level_sum
+{
+	int count;
+	int patchno_sum;
+};
+
+void cb_level_sum(fclaw2d_domain_t *domain,
+                  fclaw2d_patch_t *patch,
+                  int blockno,
+                  int patchno,
+                  void *local,
+                  void *user)
+{
+	level_sum *s = (level_sum *) local;
+	s->count++;
+	s->patchno_sum += patchno;
+}
+
+void combine_level_sum(void *result, const void *local)
+{
+	level_sum *r = (level_sum *) result;
+	const level_sum *l = (const level_sum *) local;
+	r->count += l->count;
+	r->patchno_sum += l->patchno_sum;
+}
+
+struct batch_check
+{
+	int count;
+	int batches;
+	int errors;
+	int expected_iter;
+};
+
+void cb_batch_check(fclaw2d_domain_t *domain,
+                    fclaw2d_patch_t *patch,
+                    int blockno,
+                    int patchno,
+                    int batch_iter,
+                    int batch_count,
+                    void *local,
+                    void *user)
+{
+	batch_check *b = (batch_check *) local;
+	int batch_size = *((int *) user);
+	/* Batches are visited in order by one thread */
+	if (batch_iter != b->expected_iter || batch_count > batch_size)
+	{
+		b->errors++;
+	}
+	b->count++;
+	b->expected_iter = batch_iter + 1;
+	if (batch_iter == batch_count - 1)
+	{
+		b->batches++;
+		b->expected_iter = 0;
+	}
+}
+
+void combine_batch_check(void *result, const void *local)
+{
+	batch_check *r = (batch_check *) result;
+	const batch_check *l = (const batch_check *) local;
+	r->count += l->count;
+	r->batches += l->batches;
+	r->errors += l->errors + (l->expected_iter != 0);
+}
+
+/* Refine every fourth local patch */
+void mark_refine_some(fclaw2d_domain_t *domain)
+{
+	for(int nb = 0; nb < domain->num_blocks; nb++)
+	{
+		for(int np = 0; np < domain->blocks[nb].num_patches; np += 4)
+		{
+			fclaw2d_patch_mark_refine(domain, nb, np);
+		}
+	}
+}
+
+/* Adapt after mark_refine_some; the old domain is destroyed */
+fclaw2d_domain_t* adapt(fclaw2d_domain_t *domain)
+{
+	mark_refine_some(domain);
+	fclaw2d_domain_t *adapted = fclaw2d_domain_adapt(domain);
+	REQUIRE(adapted != NULL);
+	fclaw2d_domain_destroy(domain);
+	return adapted;
+}
+
+/* Finish a partition that may or may not have moved patches */
+fclaw2d_domain_t* complete_partition(fclaw2d_domain_t *domain,
+                                     fclaw2d_domain_t *partitioned)
+{
+	if(partitioned == NULL)
+	{
+		return domain;
+	}
+	fclaw2d_domain_destroy(domain);
+	fclaw2d_domain_complete(partitioned);
+	return partitioned;
+}
+
+/* Number of values sent with a patch, varying with its global index */
+int transfer_count(int64_t gpatchno)
+{
+	return (int) (gpatchno % 3);
+}
+
+int cb_fine_heavy(fclaw2d_domain_t *domain,
+                  fclaw2d_patch_t *patch,
+                  int blockno,
+                  int patchno,
+                  void *user)
+{
+	int *calls = (int *) user;
+	(*calls)++;
+	return patch->level > 2 ? 8 : 1;
+}
+
+}
+
+TEST_CASE("fclaw2d_domain_partition_weighted leaves the domain ready for the next regrid")
+{
+	fclaw2d_domain_t *domain = fclaw2d_domain_new_unitsquare(sc_MPI_COMM_WORLD, 2);
+
+	for(int regrid = 0; regrid < 3; regrid++)
+	{
+		domain = adapt(domain);
+		int calls = 0;
+		int num_patches = domain->local_num_patches;
+		fclaw2d_domain_t *partitioned =
+			fclaw2d_domain_partition_weighted(domain, cb_fine_heavy, &calls);
+		CHECK_EQ(calls, num_patches);
+		domain = complete_partition(domain, partitioned);
+		CHECK_FALSE(domain->just_adapted);
+		CHECK_FALSE(domain->just_partitioned);
+	}
+
+	fclaw2d_domain_destroy(domain);
+}
+
+TEST_CASE("fclaw2d_domain_keep_partition finishes an adapt without a partition")
+{
+	fclaw2d_domain_t *domain = fclaw2d_domain_new_unitsquare(sc_MPI_COMM_WORLD, 2);
+
+	/* Alternate skipped and real partitions */
+	for(int regrid = 0; regrid < 4; regrid++)
+	{
+		domain = adapt(domain);
+		if(regrid % 2 == 0)
+		{
+			int num_patches = domain->local_num_patches;
+			fclaw2d_domain_keep_partition(domain);
+			CHECK_EQ(domain->local_num_patches, num_patches);
+		}
+		else
+		{
+			fclaw2d_domain_t *partitioned = fclaw2d_domain_partition(domain, 0);
+			domain = complete_partition(domain, partitioned);
+		}
+		CHECK_FALSE(domain->just_adapted);
+		CHECK_FALSE(domain->just_partitioned);
+	}
+
+	fclaw2d_domain_destroy(domain);
+}
+
+TEST_CASE("fclaw2d_domain_transfer_after_partition sends data of varying size")
+{
+	fclaw2d_domain_t *domain = fclaw2d_domain_new_unitsquare(sc_MPI_COMM_WORLD, 2);
+
+	for(int regrid = 0; regrid < 2; regrid++)
+	{
+		domain = adapt(domain);
+
+		std::vector<int> src_sizes;
+		std::vector<int64_t> src_data;
+		for(int np = 0; np < domain->local_num_patches; np++)
+		{
+			int64_t gpatchno = domain->global_num_patches_before + np;
+			int count = transfer_count(gpatchno);
+			src_sizes.push_back(count*sizeof(int64_t));
+			src_data.insert(src_data.end(), count, gpatchno);
+		}
+
+		int64_t *old_offsets = fclaw2d_domain_save_partition(domain);
+		fclaw2d_domain_t *partitioned = fclaw2d_domain_partition(domain, 0);
+		if(partitioned != NULL)
+		{
+			void *dest_data;
+			int *dest_sizes;
+			fclaw2d_domain_transfer_after_partition(partitioned, old_offsets,
+			                                        src_data.data(),
+			                                        src_sizes.data(),
+			                                        &dest_data, &dest_sizes);
+
+			/* Patches that stay local are copied as well */
+			const int64_t *data = (const int64_t *) dest_data;
+			for(int np = 0; np < partitioned->local_num_patches; np++)
+			{
+				int64_t gpatchno = partitioned->global_num_patches_before + np;
+				int count = transfer_count(gpatchno);
+				CHECK_EQ(dest_sizes[np], (int) (count*sizeof(int64_t)));
+				for(int i = 0; i < count; i++)
+				{
+					CHECK_EQ(*data++, gpatchno);
+				}
+			}
+			FCLAW_FREE(dest_data);
+			FCLAW_FREE(dest_sizes);
+		}
+		FCLAW_FREE(old_offsets);
+		domain = complete_partition(domain, partitioned);
+	}
+
+	fclaw2d_domain_destroy(domain);
+}
+
+TEST_CASE("fclaw2d_domain_iterate_level_batched visits batches in order")
+{
+	fclaw2d_domain_t *domain = fclaw2d_domain_new_unitsquare(sc_MPI_COMM_WORLD, 3);
+	int level = 3;
+	int num_patches = domain->local_num_patches;
+
+	for(int batch_size : {1, 3, 16, 1000})
+	{
+		batch_check result = {0, 0, 0, 0};
+		fclaw2d_domain_iterate_level_batched(domain, level, batch_size,
+		                                     NULL, 0, cb_batch_check, &batch_size,
+		                                     &result, sizeof(batch_check),
+		                                     combine_batch_check);
+
+		CHECK_EQ(result.count, num_patches);
+		CHECK_EQ(result.batches, (num_patches + batch_size - 1)/batch_size);
+		CHECK_EQ(result.errors, 0);
+	}
+
+	fclaw2d_domain_destroy(domain);
+}
+
+TEST_CASE("fclaw2d_domain_iterate_level_reduce visits every patch on the level once")
+{
+	for(int level : {0, 1, 3})
+	{
+		fclaw2d_domain_t *domain = fclaw2d_domain_new_unitsquare(sc_MPI_COMM_WORLD, level);
+
+		int expected_sum = 0;
+		for(int i = 0; i < domain->local_num_patches; i++)
+		{
+			expected_sum += i;
+		}
+
+		level_sum result = {0, 0};
+		fclaw2d_domain_iterate_level_reduce(domain, level, cb_level_sum, NULL,
+		                                    &result, sizeof(level_sum),
+		                                    combine_level_sum);
+
+		CHECK_EQ(result.count, domain->local_num_patches);
+		CHECK_EQ(result.patchno_sum, expected_sum);
+
+		/* No patches on a level that is not present */
+		level_sum empty = {0, 0};
+		fclaw2d_domain_iterate_level_reduce(domain, level + 1, cb_level_sum, NULL,
+		                                    &empty, sizeof(level_sum),
+		                                    combine_level_sum);
+		CHECK_EQ(empty.count, 0);
+
+		fclaw2d_domain_destroy(domain);
+	}
+}
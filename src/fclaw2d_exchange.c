@@ -137,15 +137,20 @@ unpack_remote_ghost_patches(fclaw2d_global_t* glob,
                             int time_interp)
 {
     fclaw2d_domain_t *domain = glob->domain;
+    fclaw2d_domain_data_t *ddata = fclaw2d_domain_get_data(domain);
 
-    int i;
-    for(i = 0; i < domain->num_ghost_patches; i++)
-    {
-        fclaw2d_patch_t* ghost_patch = &domain->ghost_patches[i];
-        int level = ghost_patch->level;
+    /* Only levels that were part of the exchange */
+    int level_lo = SC_MAX(time_interp ? minlevel-1 : minlevel, 0);
+    int level_hi = SC_MIN(maxlevel, ddata->exchange_num_levels-1);
 
-        if (level >= minlevel-1)
+    int level, k;
+    for(level = level_lo; level <= level_hi; level++)
+    {
+        for(k = ddata->ghost_level_offset[level];
+            k < ddata->ghost_level_offset[level+1]; k++)
         {
+            int i = ddata->ghost_level_index[k];
+            fclaw2d_patch_t* ghost_patch = &domain->ghost_patches[i];
             int blockno = ghost_patch->u.blockno;
 
             int patchno = i;
@@ -164,6 +169,94 @@ unpack_remote_ghost_patches(fclaw2d_global_t* glob,
     }
 }
 
+/* Sort local exchange patches and remote ghost patches by level (counting
+   sort, so the original order is kept within a level). */
+static
+void build_level_lists(fclaw2d_global_t* glob)
+{
+    fclaw2d_domain_t *domain = glob->domain;
+    fclaw2d_domain_data_t *ddata = fclaw2d_domain_get_data(domain);
+    int num_levels = SC_MAX(domain->global_maxlevel,0) + 1;
+    int *eoff, *goff;
+    int i, level, nb, np, zz;
+
+    eoff = FCLAW_ALLOC_ZERO(int,num_levels + 1);
+    goff = FCLAW_ALLOC_ZERO(int,num_levels + 1);
+
+    for (nb = 0; nb < domain->num_blocks; ++nb)
+    {
+        for (np = 0; np < domain->blocks[nb].num_patches; ++np)
+        {
+            fclaw2d_patch_t *patch = &domain->blocks[nb].patches[np];
+            if (patch->flags & FCLAW2D_PATCH_ON_PARALLEL_BOUNDARY)
+            {
+                FCLAW_ASSERT(patch->level < num_levels);
+                eoff[patch->level + 1]++;
+            }
+        }
+    }
+    for (i = 0; i < domain->num_ghost_patches; i++)
+    {
+        FCLAW_ASSERT(domain->ghost_patches[i].level < num_levels);
+        goff[domain->ghost_patches[i].level + 1]++;
+    }
+    for (level = 0; level < num_levels; level++)
+    {
+        eoff[level + 1] += eoff[level];
+        goff[level + 1] += goff[level];
+    }
+
+    int *ecount = FCLAW_ALLOC_ZERO(int,num_levels);
+    int *gcount = FCLAW_ALLOC_ZERO(int,num_levels);
+    ddata->exchange_level_index = FCLAW_ALLOC(int,eoff[num_levels]);
+    ddata->exchange_level_patches = FCLAW_ALLOC(fclaw2d_patch_t*,eoff[num_levels]);
+    ddata->ghost_level_index = FCLAW_ALLOC(int,goff[num_levels]);
+
+    zz = 0;
+    for (nb = 0; nb < domain->num_blocks; ++nb)
+    {
+        for (np = 0; np < domain->blocks[nb].num_patches; ++np)
+        {
+            fclaw2d_patch_t *patch = &domain->blocks[nb].patches[np];
+            if (patch->flags & FCLAW2D_PATCH_ON_PARALLEL_BOUNDARY)
+            {
+                int k = eoff[patch->level] + ecount[patch->level]++;
+                ddata->exchange_level_index[k] = zz++;
+                ddata->exchange_level_patches[k] = patch;
+            }
+        }
+    }
+    for (i = 0; i < domain->num_ghost_patches; i++)
+    {
+        level = domain->ghost_patches[i].level;
+        ddata->ghost_level_index[goff[level] + gcount[level]++] = i;
+    }
+    FCLAW_FREE(ecount);
+    FCLAW_FREE(gcount);
+
+    ddata->exchange_num_levels = num_levels;
+    ddata->exchange_level_offset = eoff;
+    ddata->ghost_level_offset = goff;
+}
+
+static
+void destroy_level_lists(fclaw2d_domain_t* domain)
+{
+    fclaw2d_domain_data_t *ddata = fclaw2d_domain_get_data(domain);
+
+    FCLAW_FREE(ddata->exchange_level_offset);
+    FCLAW_FREE(ddata->exchange_level_index);
+    FCLAW_FREE(ddata->exchange_level_patches);
+    FCLAW_FREE(ddata->ghost_level_offset);
+    FCLAW_FREE(ddata->ghost_level_index);
+    ddata->exchange_level_offset = NULL;
+    ddata->exchange_level_index = NULL;
+    ddata->exchange_level_patches = NULL;
+    ddata->ghost_level_offset = NULL;
+    ddata->ghost_level_index = NULL;
+    ddata->exchange_num_levels = 0;
+}
+
 /* --------------------------------------------------------------------------
    Public interface
    -------------------------------------------------------------------------- */
@@ -207,6 +300,12 @@ void fclaw2d_exchange_setup(fclaw2d_global_t* glob,
         }
     }
 
+    build_level_lists(glob);
+
+    /* The exchange pattern is fixed until the next regrid;  set up
+       persistent requests and message buffers once. */
+    fclaw2d_domain_ghost_exchange_persistent_setup(domain, e);
+
     /* ---------------------------------------------------------
        Start send for ghost patch meta-data needed to handle
        multi-proc corner case
@@ -288,6 +387,12 @@ void fclaw2d_exchange_delete(fclaw2d_global_t* glob)
         }
     }
 
+    if (e_old != NULL)
+    {
+        fclaw2d_domain_ghost_exchange_persistent_free(*domain, e_old);
+    }
+    destroy_level_lists(*domain);
+
     /* Delete ghost patches from remote neighboring patches */
     delete_remote_ghost_patches(glob);
     fclaw2d_domain_free_after_exchange (*domain, e_old);
@@ -317,31 +422,28 @@ void fclaw2d_exchange_ghost_patches_begin(fclaw2d_global_t* glob,
     fclaw2d_domain_exchange_t *e = get_exchange_data(glob);
 
     /* Pack local data into on-proc patches at the parallel boundary that
-       will be shipped of to other processors. */
-    int zz = 0;
-    int nb;
-    for (nb = 0; nb < domain->num_blocks; ++nb)
+       will be shipped of to other processors.  Only levels that are part of
+       this exchange are packed;  during subcycling, coarser levels have
+       not changed and are not sent. */
+    fclaw2d_domain_data_t *ddata = fclaw2d_domain_get_data(domain);
+    int level_lo = SC_MAX(time_interp ? minlevel-1 : minlevel, 0);
+    int level_hi = SC_MIN(maxlevel, ddata->exchange_num_levels-1);
+    int level, k;
+    for (level = level_lo; level <= level_hi; level++)
     {
-        int np;
-        for (np = 0; np < domain->blocks[nb].num_patches; ++np)
+        int pack_time_interp = time_interp && level == minlevel-1;
+        for (k = ddata->exchange_level_offset[level];
+             k < ddata->exchange_level_offset[level+1]; k++)
         {
-            if (domain->blocks[nb].patches[np].flags &
-                FCLAW2D_PATCH_ON_PARALLEL_BOUNDARY)
-            {
-                fclaw2d_patch_t *this_patch = &domain->blocks[nb].patches[np];
-                int level = this_patch->level;
-                FCLAW_ASSERT(level <= maxlevel);
+            fclaw2d_patch_t *this_patch = ddata->exchange_level_patches[k];
+            int zz = ddata->exchange_level_index[k];
 
-                int pack_time_interp = time_interp && level == minlevel-1;
-
-                /* Pack q and area into one contingous block */
-                fclaw2d_patch_local_ghost_pack(glob,this_patch,
-                                               e->patch_data[zz++],
-                                               pack_time_interp);
-            }
+            /* Pack q and area into one contingous block */
+            fclaw2d_patch_local_ghost_pack(glob,this_patch,
+                                           e->patch_data[zz],
+                                           pack_time_interp);
         }
     }
-
     fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_GHOSTPATCH_BUILD]);
 
     if (running != FCLAW2D_TIMER_NONE)
@@ -70,14 +70,7 @@ void get_face_neighbors(fclaw2d_global_t *glob,
 						int this_block_idx,
 						int this_patch_idx,
 						int iface,
-						int is_block_face,
-						int *neighbor_block_idx,
-						fclaw2d_patch_t* neighbor_patches[],						
-						int **ref_flag_ptr,
-						int **fine_grid_pos_ptr,
-						int **iface_neighbor_ptr,
-						int ftransform[],
-						fclaw2d_patch_transform_data_t* ftransform_finegrid)
+						fclaw2d_ghost_fill_face_plan_t *fplan)
 {
 	fclaw2d_domain_t *domain = glob->domain;
 	int rproc[FCLAW2D_NUMFACENEIGHBORS];
@@ -89,8 +82,10 @@ void get_face_neighbors(fclaw2d_global_t *glob,
 
 	for(ir = 0; ir < FCLAW2D_NUMFACENEIGHBORS; ir++)
 	{
-		neighbor_patches[ir] = NULL;
+		fplan->neighbor_patches[ir] = NULL;
 	}
+	fplan->fine_grid_pos = -1;
+	fplan->block_iface_finegrid = -1;
 
 	fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_NEIGHBOR_SEARCH]);
 	fclaw2d_patch_relation_t neighbor_type =
@@ -122,46 +117,45 @@ void get_face_neighbors(fclaw2d_global_t *glob,
 	}
 	else
 	{
-		*neighbor_block_idx = is_block_face ? rblockno : -1;
+		int is_block_face = fplan->is_block_face;
+		fplan->neighbor_block_idx = is_block_face ? rblockno : -1;
 		/* Get encoding of transforming a neighbor coordinate across a face */
-		fclaw2d_patch_transform_blockface (glob, iface, rfaceno, ftransform);
+		fclaw2d_patch_transform_blockface (glob, iface, rfaceno, fplan->transform);
 
 		int iface1, rface1;
 		iface1 = iface;
 		rface1 = rfaceno;
 		fclaw2d_patch_face_swap(&iface1,&rface1);
 		fclaw2d_patch_transform_blockface (glob, iface1, rface1,
-										   ftransform_finegrid->transform);
-		ftransform_finegrid->block_iface = iface1;
-		**iface_neighbor_ptr = iface1;
+										   fplan->transform_finegrid);
+		fplan->block_iface_finegrid = iface1;
+		fplan->iface_neighbor = iface1;
 
 
 		if (!is_block_face)
 		{
 			/* If we are within one patch this is a special case */
-			FCLAW_ASSERT (*neighbor_block_idx == -1);
-			fclaw2d_patch_transform_blockface_intra (glob, ftransform);
+			FCLAW_ASSERT (fplan->neighbor_block_idx == -1);
+			fclaw2d_patch_transform_blockface_intra (glob, fplan->transform);
 			fclaw2d_patch_transform_blockface_intra
-				(glob, ftransform_finegrid->transform);
+				(glob, fplan->transform_finegrid);
 		}
 
 		if (neighbor_type == FCLAW2D_PATCH_SAMESIZE)
 		{
-			**ref_flag_ptr = 0;
-			*fine_grid_pos_ptr = NULL;
+			fplan->neighbor_level = SAMESIZE_GRID;
 			num_neighbors = 1;
 		}
 		else if (neighbor_type == FCLAW2D_PATCH_DOUBLESIZE)
 		{
-			**ref_flag_ptr = -1;
-			**fine_grid_pos_ptr = rproc[1];    /* Special storage for fine grid info */
+			fplan->neighbor_level = COARSER_GRID;
+			fplan->fine_grid_pos = rproc[1];    /* Special storage for fine grid info */
 			num_neighbors = 1;
 		}
 		else if (neighbor_type == FCLAW2D_PATCH_HALFSIZE)
 		{
 			/* Patch has two neighbors */
-			**ref_flag_ptr = 1; /* patches are at one level finer */
-			*fine_grid_pos_ptr = NULL;
+			fplan->neighbor_level = FINER_GRID; /* patches are at one level finer */
 			num_neighbors = FCLAW2D_NUMFACENEIGHBORS;
 		}
 		else
@@ -184,7 +178,43 @@ void get_face_neighbors(fclaw2d_global_t *glob,
 				/* neighbor patch is on a remote processor */
 				neighbor = &domain->ghost_patches[rpatchno[ir]];
 			}
-			neighbor_patches[ir] = neighbor;
+			fplan->neighbor_patches[ir] = neighbor;
+		}
+	}
+}
+
+void fclaw2d_face_neighbors_plan(fclaw2d_global_t *glob,
+								 fclaw2d_patch_t *this_patch,
+								 int this_block_idx,
+								 int this_patch_idx,
+								 fclaw2d_ghost_fill_face_plan_t *face_plan)
+{
+	int intersects_phys_bdry[FCLAW2D_NUMFACES];
+	int intersects_block[FCLAW2D_NUMFACES];
+	int iface;
+
+	fclaw2d_physical_get_bc(glob,this_block_idx,this_patch_idx,
+							intersects_phys_bdry);
+
+	fclaw2d_block_get_block_boundary(glob, this_patch, intersects_block);
+
+	for (iface = 0; iface < FCLAW2D_NUMFACES; iface++)
+	{
+		fclaw2d_ghost_fill_face_plan_t *fplan = &face_plan[iface];
+		get_face_type(glob,
+					  iface,
+					  intersects_phys_bdry,
+					  intersects_block,
+					  &fplan->is_block_face,
+					  &fplan->is_interior_face);
+
+		if (fplan->is_interior_face)
+		{
+			get_face_neighbors(glob,
+							   this_block_idx,
+							   this_patch_idx,
+							   iface,
+							   fplan);
 		}
 	}
 }
@@ -219,13 +249,25 @@ void cb_face_fill(fclaw2d_domain_t *domain,
 	const fclaw_options_t *gparms = fclaw2d_get_options(s->glob);
 	const int refratio = gparms->refratio;
 
-	int intersects_phys_bdry[FCLAW2D_NUMFACES];
-	int intersects_block[FCLAW2D_NUMFACES];
-
-	fclaw2d_physical_get_bc(s->glob,this_block_idx,this_patch_idx,
-							intersects_phys_bdry);
-
-	fclaw2d_block_get_block_boundary(s->glob, this_patch, intersects_block);
+	/* Use neighbor information cached at the last regrid if we have it;
+	   otherwise search for the neighbors now. */
+	fclaw2d_ghost_fill_face_plan_t face_plan_local[FCLAW2D_NUMFACES];
+	fclaw2d_ghost_fill_face_plan_t *face_plan;
+	fclaw2d_ghost_fill_plan_t *plan = fclaw2d_ghost_fill_plan_get(domain);
+	if (plan != NULL)
+	{
+		int patch_num = domain->blocks[this_block_idx].num_patches_before
+		                + this_patch_idx;
+		FCLAW_ASSERT(0 <= patch_num && patch_num < plan->num_patches);
+		face_plan = &plan->faces[FCLAW2D_NUMFACES*patch_num];
+	}
+	else
+	{
+		fclaw2d_face_neighbors_plan(s->glob,this_patch,
+									this_block_idx,this_patch_idx,
+									face_plan_local);
+		face_plan = face_plan_local;
+	}
 
 
 	/* Transform data needed at block boundaries */
@@ -255,63 +297,34 @@ void cb_face_fill(fclaw2d_domain_t *domain,
 	{
 		int idir = iface/2;
 
-		int is_block_face;
-		int is_interior_face;
-		get_face_type(s->glob,
-					  iface,
-					  intersects_phys_bdry,
-					  intersects_block,
-					  &is_block_face,
-					  &is_interior_face);
-
+		const fclaw2d_ghost_fill_face_plan_t *fplan = &face_plan[iface];
 
-		if (is_interior_face)  /* Not on a physical boundary */
+		if (fplan->is_interior_face)  /* Not on a physical boundary */
 		{
-			/* Output arguments */
-			int neighbor_block_idx;
-			int neighbor_level;   /* = -1, 0, 1 */
-			int *ref_flag_ptr = &neighbor_level;
-			int fine_grid_pos = -1;
-			int *fine_grid_pos_ptr = &fine_grid_pos;
+			int neighbor_block_idx = fplan->neighbor_block_idx;
+			int neighbor_level = fplan->neighbor_level;   /* = -1, 0, 1 */
+			int fine_grid_pos = fplan->fine_grid_pos;
 
 			/* Get the face neighbor relative to the neighbor's coordinate
 			   orientation (this isn't used here) */
-			int iface_neighbor;
-			int *iface_neighbor_ptr = &iface_neighbor;
+			int iface_neighbor = fplan->iface_neighbor;
 
-			fclaw2d_patch_t* neighbor_patches[FCLAW2D_NUMFACENEIGHBORS];
+			fclaw2d_patch_t* const* neighbor_patches = fplan->neighbor_patches;
 
 			/* Reset this in case it got set in a remote copy */
 			transform_data.this_patch = this_patch;
-			transform_data_finegrid.block_iface = -1;
 
 			/* transform_data.block_iface = iface; */
-			get_face_neighbors(s->glob,
-							   this_block_idx,
-							   this_patch_idx,
-							   iface,
-							   is_block_face,
-							   &neighbor_block_idx,
-							   neighbor_patches,
-							   &ref_flag_ptr,
-							   &fine_grid_pos_ptr,
-							   &iface_neighbor_ptr,
-							   transform_data.transform,
-							   &transform_data_finegrid);
+			memcpy(transform_data.transform,fplan->transform,
+			       sizeof(transform_data.transform));
+			memcpy(transform_data_finegrid.transform,fplan->transform_finegrid,
+			       sizeof(transform_data_finegrid.transform));
+			transform_data_finegrid.block_iface = fplan->block_iface_finegrid;
 
 			/* Needed for switching the context */
 			transform_data_finegrid.this_patch = neighbor_patches[0];
 			transform_data_finegrid.neighbor_patch = this_patch;
 
-
-			/* int block_boundary = (neighbor_block_idx >= 0); */
-			if (ref_flag_ptr == NULL)
-			{
-				/* We should never end up here */
-				printf("cb_face_fill (fclaw2d_face_neighbors.cpp) : no face found\n");
-				exit(0);
-			}
-
 			/* Parallel distribution keeps siblings on same processor */
 			int remote_neighbor;
 			remote_neighbor = fclaw2d_patch_is_ghost(neighbor_patches[0]);
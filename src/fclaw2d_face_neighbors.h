@@ -37,7 +37,22 @@ extern "C"
 struct fclaw2d_global;
 struct fclaw2d_domain;
 struct fclaw2d_patch;
+struct fclaw2d_ghost_fill_face_plan;
 
+/**
+ * @brief Search for the neighbors across each face of a local patch.
+ *
+ * @param[in] glob the global context
+ * @param[in] this_patch the patch
+ * @param[in] this_block_idx the block number
+ * @param[in] this_patch_idx the patch number (local to the block)
+ * @param[out] face_plan neighbor information, one entry per face
+ */
+void fclaw2d_face_neighbors_plan(struct fclaw2d_global *glob,
+                                 struct fclaw2d_patch *this_patch,
+                                 int this_block_idx,
+                                 int this_patch_idx,
+                                 struct fclaw2d_ghost_fill_face_plan *face_plan);
 
 void cb_face_fill(struct fclaw2d_domain *domain,
                   struct fclaw2d_patch *this_patch,
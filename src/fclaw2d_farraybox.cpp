@@ -24,10 +24,19 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include <fclaw2d_defs.h>
+#include <fclaw_base.h>
 #include <sc.h>
 
 #include <fclaw2d_farraybox.hpp>
 
+#include <map>
+#include <utility>
+#include <stdlib.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
 /* Difference in nan values :
    The first one is not trapped; the second one is.
 
@@ -71,6 +80,212 @@ void fclaw2d_farraybox_set_to_nan(double& f)
 
 
 
+/* ------------------------------------------------------------------
+   Block pool.  The FArrayBoxes of a run come in only a few sizes
+   (solution, aux, metric and scratch data per patch), so blocks of each
+   size are carved out of large slabs and kept on a free list when
+   released.  Slabs whose blocks are all free again are returned to the
+   system by fclaw2d_farraybox_pool_trim.
+   ------------------------------------------------------------------ */
+
+#define FCLAW2D_FARRAYBOX_SLAB_BYTES (2*1024*1024)
+
+struct farraybox_slab
+{
+    double *base;
+    size_t nblocks;
+};
+
+struct farraybox_size_class
+{
+    std::vector<farraybox_slab> slabs;
+    std::vector<double*> free_blocks;
+    long in_use = 0;
+};
+
+static std::map<int,farraybox_size_class>& farraybox_pool()
+{
+    /* Never destroyed, so blocks can be released during static destruction */
+    static std::map<int,farraybox_size_class> *pool
+        = new std::map<int,farraybox_size_class>;
+    return *pool;
+}
+
+static size_t s_pool_reserved = 0;
+static size_t s_pool_in_use = 0;
+
+static
+void farraybox_add_slab(farraybox_size_class& c, int size)
+{
+    size_t block_bytes = (size_t) size*sizeof(double);
+    size_t nblocks = SC_MAX(1,FCLAW2D_FARRAYBOX_SLAB_BYTES/block_bytes);
+    size_t slab_bytes = nblocks*block_bytes;
+    size_t alignment = slab_bytes >= FCLAW2D_FARRAYBOX_SLAB_BYTES ?
+                       FCLAW2D_FARRAYBOX_SLAB_BYTES : 64;
+    void *slab;
+    if (posix_memalign(&slab,alignment,slab_bytes) != 0)
+    {
+        printf("FArrayBox : Could not allocate %zu bytes\n",slab_bytes);
+        exit(1);
+    }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (slab_bytes >= FCLAW2D_FARRAYBOX_SLAB_BYTES)
+    {
+        /* Only a hint; ignored if transparent huge pages are disabled */
+        madvise(slab,slab_bytes,MADV_HUGEPAGE);
+    }
+#endif
+    for (size_t i = 0; i < nblocks; i++)
+    {
+        c.free_blocks.push_back((double*) slab + i*size);
+    }
+    c.slabs.push_back({(double*) slab, nblocks});
+    s_pool_reserved += slab_bytes;
+}
+
+/* Free the slabs of a size class that have no block in use */
+static
+size_t farraybox_trim_size_class(farraybox_size_class& c, int size)
+{
+    if (c.free_blocks.empty())
+    {
+        return 0;
+    }
+
+    /* Count the free blocks of each slab */
+    std::map<double*,size_t> slab_index;
+    for (size_t i = 0; i < c.slabs.size(); i++)
+    {
+        slab_index[c.slabs[i].base] = i;
+    }
+    std::vector<size_t> nfree(c.slabs.size(),0);
+    std::vector<size_t> block_slab(c.free_blocks.size());
+    for (size_t k = 0; k < c.free_blocks.size(); k++)
+    {
+        std::map<double*,size_t>::iterator it = 
+                slab_index.upper_bound(c.free_blocks[k]);
+        FCLAW_ASSERT(it != slab_index.begin());
+        --it;
+        block_slab[k] = it->second;
+        nfree[it->second]++;
+    }
+
+    size_t released = 0;
+    std::vector<double*> free_blocks;
+    for (size_t k = 0; k < c.free_blocks.size(); k++)
+    {
+        const farraybox_slab& slab = c.slabs[block_slab[k]];
+        if (nfree[block_slab[k]] < slab.nblocks)
+        {
+            free_blocks.push_back(c.free_blocks[k]);
+        }
+    }
+    std::vector<farraybox_slab> slabs;
+    for (size_t i = 0; i < c.slabs.size(); i++)
+    {
+        if (nfree[i] == c.slabs[i].nblocks)
+        {
+            free(c.slabs[i].base);
+            released += c.slabs[i].nblocks*size*sizeof(double);
+        }
+        else
+        {
+            slabs.push_back(c.slabs[i]);
+        }
+    }
+    c.free_blocks.swap(free_blocks);
+    c.slabs.swap(slabs);
+    return released;
+}
+
+static
+double* farraybox_pool_alloc(int size)
+{
+    double *block;
+#pragma omp critical(fclaw2d_farraybox_pool)
+    {
+        farraybox_size_class& c = farraybox_pool()[size];
+        if (c.free_blocks.empty())
+        {
+            farraybox_add_slab(c,size);
+        }
+        block = c.free_blocks.back();
+        c.free_blocks.pop_back();
+        c.in_use++;
+        s_pool_in_use += (size_t) size*sizeof(double);
+    }
+    return block;
+}
+
+static
+void farraybox_pool_free(double *block, int size)
+{
+#pragma omp critical(fclaw2d_farraybox_pool)
+    {
+        std::map<int,farraybox_size_class>& pool = farraybox_pool();
+        std::map<int,farraybox_size_class>::iterator it = pool.find(size);
+        FCLAW_ASSERT(it != pool.end() && it->second.in_use > 0);
+        farraybox_size_class& c = it->second;
+        c.free_blocks.push_back(block);
+        c.in_use--;
+        s_pool_in_use -= (size_t) size*sizeof(double);
+    }
+}
+
+size_t fclaw2d_farraybox_pool_trim()
+{
+    size_t released = 0;
+#pragma omp critical(fclaw2d_farraybox_pool)
+    {
+        std::map<int,farraybox_size_class>& pool = farraybox_pool();
+        std::map<int,farraybox_size_class>::iterator it = pool.begin();
+        while (it != pool.end())
+        {
+            released += farraybox_trim_size_class(it->second,it->first);
+            if (it->second.slabs.empty())
+            {
+                it = pool.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        s_pool_reserved -= released;
+    }
+    return released;
+}
+
+void fclaw2d_farraybox_pool_stats(size_t *bytes_reserved, size_t *bytes_in_use)
+{
+#pragma omp critical(fclaw2d_farraybox_pool)
+    {
+        *bytes_reserved = s_pool_reserved;
+        *bytes_in_use = s_pool_in_use;
+    }
+}
+
+std::shared_ptr<double> fclaw2d_farraybox_storage_new(size_t count)
+{
+    size_t bytes = SC_MAX(count,1)*sizeof(double);
+    size_t alignment = bytes >= FCLAW2D_FARRAYBOX_SLAB_BYTES ?
+                       FCLAW2D_FARRAYBOX_SLAB_BYTES : 64;
+    void *data;
+    if (posix_memalign(&data,alignment,bytes) != 0)
+    {
+        printf("FArrayBox : Could not allocate %zu bytes\n",bytes);
+        exit(1);
+    }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (bytes >= FCLAW2D_FARRAYBOX_SLAB_BYTES)
+    {
+        madvise(data,bytes,MADV_HUGEPAGE);
+    }
+#endif
+    return std::shared_ptr<double>((double*) data, free);
+}
+
+
 FArrayBox::FArrayBox()
 {
     m_data = NULL;
@@ -81,20 +296,32 @@ FArrayBox::FArrayBox()
 
 FArrayBox::~FArrayBox()
 {
-    if (m_data != NULL)
+    release();
+}
+
+/* Give up m_data, returning it to the pool unless it is a view */
+void FArrayBox::release()
+{
+    if (m_storage)
+    {
+        m_storage.reset();
+    }
+    else if (m_data != NULL)
     {
-        delete [] m_data;
-        m_data = NULL;
+        farraybox_pool_free(m_data,m_size);
     }
+    m_data = NULL;
 }
 
 FArrayBox::FArrayBox(const FArrayBox& A)
 {
+    m_data = NULL;
+    m_size = 0;
+    /* A re-allocation, but should hopefully, memory management should be okay */
+    set_dataPtr(A.m_size);
     m_box = A.m_box;
     m_size = A.m_size;
     m_fields = A.m_fields;
-    /* A re-allocation, but should hopefully, memory management should be okay */
-    set_dataPtr(A.m_size);
 }
 
 void FArrayBox::set_dataPtr(int a_size)
@@ -106,26 +333,18 @@ void FArrayBox::set_dataPtr(int a_size)
     }
     else if (a_size == 0)
     {
-        if (m_data != NULL)
-        {
-            delete [] m_data;
-        }
-        m_data = NULL;
+        release();
     }
     else
     {
-        if (m_size != a_size)
+        if (m_size != a_size || m_data == NULL)
         {
-            if (m_data != NULL)
-            {
-                delete [] m_data;
-                m_data = NULL;
-            }
-            m_data = new double[a_size];
+            release();
+            m_data = farraybox_pool_alloc(a_size);
         }
         else
         {
-            // Don't do anything;  m_data is already the right size
+            // Don't do anything;  m_data (or the view) is already the right size
         }
         double qnan, snan, big_number;
         // qnan = quiet nan
@@ -166,6 +385,33 @@ void FArrayBox::define(const Box& a_box, int a_fields)
     m_box = a_box;
 }
 
+/* Use a_data, which lies inside a_storage, instead of owning memory.
+   The current contents are not copied. */
+void FArrayBox::define_view(const Box& a_box, int a_fields,
+                            const std::shared_ptr<double>& a_storage,
+                            double *a_data)
+{
+    int box_size = 1;
+
+    for (int i = 0; i < a_box.boxDim(); ++i)
+    {
+        box_size *= (a_box.bigEnd(i) - a_box.smallEnd(i) + 1);
+    }
+
+    release();
+    m_storage = a_storage;
+    m_data = a_data;
+
+    m_size = box_size*a_fields;
+    m_fields = a_fields;
+    m_box = a_box;
+}
+
+bool FArrayBox::is_view() const
+{
+    return (bool) m_storage;
+}
+
 void FArrayBox::copyToMemory(double *data)
 {
     memcpy(data,m_data,m_size*sizeof(double));
@@ -238,6 +484,16 @@ void FArrayBox::operator=(const FArrayBox& fbox)
     }
 }
 
+/* Exchange data and layout with fbox without copying */
+void FArrayBox::swap(FArrayBox& fbox)
+{
+    std::swap(m_data, fbox.m_data);
+    std::swap(m_size, fbox.m_size);
+    std::swap(m_box, fbox.m_box);
+    std::swap(m_fields, fbox.m_fields);
+    std::swap(m_storage, fbox.m_storage);
+}
+
 double* FArrayBox::dataPtr()
 {
     return m_data;
@@ -27,10 +27,24 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define FCLAW2D_FARRAYBOX_H
 
 #include <fclaw2d_defs.h>
+#include <memory>
 #include <vector>
 
 void fclaw2d_farraybox_set_to_nan(double& f);
 
+/* FArrayBox data is allocated from a pool of equal-size blocks, so buffers
+   freed when patches are deleted (regrid, partition, ghost patches) are
+   reused for the next patches of the same size. */
+void fclaw2d_farraybox_pool_stats(size_t *bytes_reserved, size_t *bytes_in_use);
+
+/* Return slabs with no block in use to the system, so the pool does not
+   hold on to the peak memory of the run.  Returns the bytes released. */
+size_t fclaw2d_farraybox_pool_trim();
+
+/* Aligned storage for count doubles, shared by FArrayBox views (see
+   FArrayBox::define_view) and freed when the last view lets go of it. */
+std::shared_ptr<double> fclaw2d_farraybox_storage_new(size_t count);
+
 class Box
 {
 public:
@@ -54,6 +68,9 @@ public:
     FArrayBox(const FArrayBox& A);
     ~FArrayBox();
     void define(const Box& a_box, int a_fields);
+    void define_view(const Box& a_box, int a_fields,
+                     const std::shared_ptr<double>& a_storage, double *a_data);
+    bool is_view() const;
     double* dataPtr();
     Box box();
     int fields();
@@ -64,12 +81,15 @@ public:
     void operator=(const FArrayBox& fbox);
     void copyToMemory(double *data);
     void copyFromMemory(double *data);
+    void swap(FArrayBox& fbox);
 private:
     double *m_data;
     int m_size;
     Box m_box;
     int m_fields;
+    std::shared_ptr<double> m_storage;  /* set if m_data is a view */
     void set_dataPtr(int size);
+    void release();
 
 };
 
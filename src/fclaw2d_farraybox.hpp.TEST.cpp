@@ -0,0 +1,143 @@
+/*
+Copyright (c) 2012-2023 Carsten Burstedde, Donna Calhoun, Scott Aiton
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+ * Redistributions of source code must retain the above copyright notice, this
+list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+this list of conditions and the following disclaimer in the documentation
+and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <fclaw2d_farraybox.hpp>
+#include <test.hpp>
+
+TEST_CASE("FArrayBox reuses freed blocks of the same size")
+{
+	int ll[2] = {-2,-2};
+	int ur[2] = {9,9};
+	Box box(ll,ur,2);
+
+	FArrayBox *a = new FArrayBox();
+	a->define(box,3);
+	double *data = a->dataPtr();
+	REQUIRE(data != NULL);
+	CHECK(a->size() == 12*12*3);
+
+	size_t reserved, in_use;
+	fclaw2d_farraybox_pool_stats(&reserved,&in_use);
+	CHECK(in_use >= 12*12*3*sizeof(double));
+	CHECK(reserved >= in_use);
+
+	delete a;
+
+	FArrayBox b;
+	b.define(box,3);
+	CHECK(b.dataPtr() == data);
+
+	size_t reserved_after;
+	fclaw2d_farraybox_pool_stats(&reserved_after,&in_use);
+	CHECK(reserved_after == reserved);
+}
+
+TEST_CASE("FArrayBox swap exchanges data without copying")
+{
+	int ll[2] = {0,0};
+	int ur[2] = {3,3};
+	Box box(ll,ur,2);
+
+	FArrayBox a, b;
+	a.define(box,1);
+	b.define(box,2);
+	double *pa = a.dataPtr();
+	double *pb = b.dataPtr();
+
+	a.swap(b);
+	CHECK(a.dataPtr() == pb);
+	CHECK(b.dataPtr() == pa);
+	CHECK(a.fields() == 2);
+	CHECK(b.fields() == 1);
+}
+
+TEST_CASE("FArrayBox views keep shared storage alive")
+{
+	int ll[2] = {0,0};
+	int ur[2] = {3,3};
+	Box box(ll,ur,2);
+
+	FArrayBox *a = new FArrayBox();
+	FArrayBox b;
+	a->define(box,1);
+	b.define(box,1);
+
+	std::shared_ptr<double> storage = fclaw2d_farraybox_storage_new(2*16);
+	a->define_view(box,1,storage,storage.get());
+	b.define_view(box,1,storage,storage.get() + 16);
+	CHECK(a->is_view());
+	CHECK(a->dataPtr() == storage.get());
+	CHECK(b.dataPtr() == storage.get() + 16);
+	CHECK(storage.use_count() == 3);
+
+	/* redefining with the same size keeps the view */
+	b.define(box,1);
+	CHECK(b.dataPtr() == storage.get() + 16);
+
+	/* a different size moves back to pooled memory */
+	b.define(box,2);
+	CHECK_FALSE(b.is_view());
+	CHECK(storage.use_count() == 2);
+
+	delete a;
+	CHECK(storage.use_count() == 1);
+}
+
+TEST_CASE("FArrayBox pool trim returns slabs with no block in use")
+{
+	/* A size no other test uses, so its slabs belong to this test */
+	int ll[2] = {0,0};
+	int ur[2] = {36,40};
+	Box box(ll,ur,2);
+
+	FArrayBox *a = new FArrayBox();
+	FArrayBox *b = new FArrayBox();
+	a->define(box,1);
+	b->define(box,1);
+	a->dataPtr()[0] = 42;
+
+	size_t reserved, in_use;
+	fclaw2d_farraybox_pool_stats(&reserved,&in_use);
+
+	/* a still uses the slab */
+	delete b;
+	fclaw2d_farraybox_pool_trim();
+	size_t reserved_after, in_use_after;
+	fclaw2d_farraybox_pool_stats(&reserved_after,&in_use_after);
+	CHECK(reserved_after == reserved);
+	CHECK(a->dataPtr()[0] == 42);
+
+	delete a;
+	size_t released = fclaw2d_farraybox_pool_trim();
+	CHECK(released >= 37*41*sizeof(double));
+	fclaw2d_farraybox_pool_stats(&reserved_after,&in_use_after);
+	CHECK(reserved_after == reserved - released);
+	CHECK(in_use_after == in_use - 2*37*41*sizeof(double));
+
+	/* The pool still works after a trim */
+	FArrayBox c;
+	c.define(box,1);
+	CHECK(c.dataPtr() != NULL);
+}
@@ -31,6 +31,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <fclaw2d_map.h>
 #include <fclaw2d_domain.h>
 #include <fclaw2d_forestclaw.h>
+#include <fclaw2d_patch.h>
 
 /**
  *  This macro defines two utility functions for reading and writing CSV data of a specified type,
@@ -190,6 +191,7 @@ void fclaw2d_finalize(fclaw2d_global_t* glob)
         {
             fclaw_global_essentialf("Timing reports not generated for outstyle=0\n");
         }
+        fclaw2d_patch_memory_report(glob);
     }
     if (strcmp(gparms->regression_check, "") != 0)
     {
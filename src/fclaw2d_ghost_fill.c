@@ -87,6 +87,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 typedef struct fclaw2d_ghost_fill_wrap_info
 {
 	fclaw2d_ghost_fill_parallel_mode_t ghost_mode;
+	const int *patch_mask;   /* If not NULL, skip local patches with mask 0 */
 	fclaw2d_patch_callback_t cb_fill;
 	void *user;
 } fclaw2d_ghost_fill_wrap_info_t;
@@ -127,6 +128,11 @@ static void cb_parallel_wrap(fclaw2d_domain_t* domain,
 	fclaw2d_global_iterate_t* s = (fclaw2d_global_iterate_t*) user;  
 	
 	fclaw2d_ghost_fill_wrap_info_t w = *((fclaw2d_ghost_fill_wrap_info_t*) s->user);
+	if (w.patch_mask != NULL &&
+		!w.patch_mask[domain->blocks[this_block_idx].num_patches_before + this_patch_idx])
+	{
+		return;
+	}
 	int on_boundary = fclaw2d_patch_on_parallel_boundary(this_patch);
 	if (((w.ghost_mode == FCLAW2D_BOUNDARY_GHOST_ONLY) && on_boundary) ||
 		((w.ghost_mode == FCLAW2D_BOUNDARY_INTERIOR_ONLY) && !on_boundary) ||
@@ -156,6 +162,7 @@ void copy2ghost(fclaw2d_global_t *glob,
     e_info.read_parallel_patches = read_parallel_patches;
 
     parallel_mode.ghost_mode = ghost_mode;
+    parallel_mode.patch_mask = NULL;
     parallel_mode.user = (void*) &e_info;
 
     parallel_mode.cb_fill = cb_face_fill;
@@ -188,6 +195,7 @@ void average2ghost(fclaw2d_global_t *glob,
 
 	parallel_mode.user = (void*) &e_info;
 	parallel_mode.ghost_mode = ghost_mode;
+	parallel_mode.patch_mask = NULL;
 
     parallel_mode.cb_fill = cb_face_fill;
     fclaw2d_global_iterate_level(glob, coarse_level,
@@ -247,6 +255,7 @@ void interpolate2ghost(fclaw2d_global_t *glob,
     e_info.read_parallel_patches = read_parallal_patches;
 
     parallel_mode.ghost_mode = ghost_mode;
+    parallel_mode.patch_mask = NULL;
     parallel_mode.user = (void*) &e_info;
 
     /* Face interpolate */
@@ -287,7 +296,8 @@ void setphysical(fclaw2d_global_t *glob,
 				 int level,
 				 double sync_time,
 				 int time_interp,
-				 fclaw2d_ghost_fill_parallel_mode_t ghost_mode)
+				 fclaw2d_ghost_fill_parallel_mode_t ghost_mode,
+				 const int *patch_mask)
 {
 	struct fclaw2d_ghost_fill_wrap_info parallel_mode;
 
@@ -296,6 +306,7 @@ void setphysical(fclaw2d_global_t *glob,
 	t_info.time_interp = time_interp;
 
 	parallel_mode.ghost_mode = ghost_mode;
+	parallel_mode.patch_mask = patch_mask;
 	parallel_mode.user = (void*) &t_info;
 
 	parallel_mode.cb_fill = cb_fclaw2d_physical_set_bc;
@@ -430,13 +441,28 @@ void interpolate_coarse2fine_ghost(fclaw2d_global_t* glob,
 }
 
 
+/* Patches whose ghost cells at the physical boundary need to be filled, or
+   NULL for all patches.  With refresh, only those patches whose ghost cells
+   can be changed after the ghost patch exchange. */
+static
+const int* physbc_patch_mask(fclaw2d_domain_t *domain, int refresh)
+{
+	fclaw2d_ghost_fill_plan_t *plan = fclaw2d_ghost_fill_plan_get(domain);
+	if (plan == NULL)
+	{
+		return NULL;
+	}
+	return refresh ? plan->physbc_refresh : plan->physbc_patches;
+}
+
 static
 void fill_physical_ghost(fclaw2d_global_t* glob,
 						 int minlevel,
 						 int maxlevel,
 						 double sync_time,
 						 int time_interp,
-						 fclaw2d_ghost_fill_parallel_mode_t ghost_mode)
+						 fclaw2d_ghost_fill_parallel_mode_t ghost_mode,
+						 const int *patch_mask)
 {
 	fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_GHOSTFILL_PHYSBC]);
 
@@ -445,7 +471,7 @@ void fill_physical_ghost(fclaw2d_global_t* glob,
 	for(level = maxlevel; level >= minlevel; level--)
 	{
 		int time_interp = 0;
-		setphysical(glob,level,sync_time,time_interp,ghost_mode);
+		setphysical(glob,level,sync_time,time_interp,ghost_mode,patch_mask);
 	}
 	if (time_interp)
 	{
@@ -454,7 +480,8 @@ void fill_physical_ghost(fclaw2d_global_t* glob,
 					time_interp_level,
 					sync_time,
 					time_interp,
-					ghost_mode);
+					ghost_mode,
+					patch_mask);
 	}
 	fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_GHOSTFILL_PHYSBC]);
 }
@@ -504,6 +531,8 @@ void fclaw2d_ghost_update_nonasync(fclaw2d_global_t* glob,
 	int mincoarse = minlevel;
 	int maxcoarse = maxlevel-1;   /* maxlevel >= minlevel */
 
+	const int *physbc_mask = physbc_patch_mask(glob->domain,0);
+
     /* --------------------------------------------------------------
     Do work we have do before sending
     ------------------------------------------------------------*/
@@ -540,7 +569,8 @@ void fclaw2d_ghost_update_nonasync(fclaw2d_global_t* glob,
                         maxcoarse,
                         sync_time,
                         time_interp,
-                        parallel_mode);
+                        parallel_mode,
+                        physbc_mask);
 
     fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_GHOSTFILL_STEP1]);
 
@@ -584,7 +614,8 @@ void fclaw2d_ghost_update_nonasync(fclaw2d_global_t* glob,
 						maxlevel,
 						sync_time,
 						time_interp,
-						parallel_mode);
+						parallel_mode,
+						physbc_mask);
 
 	/* Interpolate */
 	interpolate_coarse2fine_ghost(glob,mincoarse, maxcoarse,
@@ -596,7 +627,8 @@ void fclaw2d_ghost_update_nonasync(fclaw2d_global_t* glob,
 						maxlevel,
 						sync_time,
 						time_interp,
-						FCLAW2D_BOUNDARY_ALL);
+						FCLAW2D_BOUNDARY_ALL,
+						physbc_mask);
 	fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_GHOSTFILL_STEP3]);
 
 	// Stop timing
@@ -608,7 +640,7 @@ void fclaw2d_ghost_update_nonasync(fclaw2d_global_t* glob,
 }
 
 
-void fclaw2d_ghost_update_async(fclaw2d_global_t* glob,
+void fclaw2d_ghost_update_begin(fclaw2d_global_t* glob,
 								int minlevel,
 								int maxlevel,
 								double sync_time,
@@ -649,6 +681,8 @@ void fclaw2d_ghost_update_async(fclaw2d_global_t* glob,
 	int mincoarse = minlevel;
 	int maxcoarse = maxlevel-1;   /* maxlevel >= minlevel */
 
+	const int *physbc_mask = physbc_patch_mask(glob->domain,0);
+
 	fclaw2d_ghost_fill_parallel_mode_t parallel_mode =
 		   FCLAW2D_BOUNDARY_ALL;
 	int read_parallel_patches;
@@ -688,7 +722,8 @@ void fclaw2d_ghost_update_async(fclaw2d_global_t* glob,
 						maxcoarse,
 						sync_time,
 						time_interp,
-						parallel_mode);
+						parallel_mode,
+						physbc_mask);
 
 	fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_GHOSTFILL_STEP1]);
 
@@ -698,12 +733,39 @@ void fclaw2d_ghost_update_async(fclaw2d_global_t* glob,
 	fclaw2d_exchange_ghost_patches_begin(glob,minlevel,maxlevel,time_interp,
 										 FCLAW2D_TIMER_GHOSTFILL);
 
+	fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_GHOSTFILL]);
+	if (running != FCLAW2D_TIMER_NONE)
+	{
+		fclaw2d_timer_start (&glob->timers[running]);
+	}
+}
+
+void fclaw2d_ghost_update_end(fclaw2d_global_t* glob,
+							  int minlevel,
+							  int maxlevel,
+							  double sync_time,
+							  int time_interp,
+							  fclaw2d_timer_names_t running)
+{
+	if (running != FCLAW2D_TIMER_NONE) {
+		fclaw2d_timer_stop (&glob->timers[running]);
+	}
+	fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_GHOSTFILL]);
+
+	int mincoarse = minlevel;
+	int maxcoarse = maxlevel-1;
+
+	const int *physbc_mask = physbc_patch_mask(glob->domain,0);
+	const int *physbc_refresh = physbc_patch_mask(glob->domain,1);
+
 	/* --------------------------------------------------------------
 		Finish exchanges in the interior of the grid.
 	------------------------------------------------------------*/
 
 	fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_GHOSTFILL_STEP2]);
-	parallel_mode = FCLAW2D_BOUNDARY_INTERIOR_ONLY;
+	fclaw2d_ghost_fill_parallel_mode_t parallel_mode =
+		FCLAW2D_BOUNDARY_INTERIOR_ONLY;
+	int read_parallel_patches = 0;
 
 	/* Average */
 	average_fine2coarse_ghost(glob,mincoarse,maxcoarse,
@@ -721,7 +783,8 @@ void fclaw2d_ghost_update_async(fclaw2d_global_t* glob,
 						maxcoarse,
 						sync_time,
 						time_interp,
-						parallel_mode);
+						parallel_mode,
+						physbc_mask);
 
 	/* Fine grids that are adjacent to boundary patches don't get
 		ghost regions filled in that overlap boundary patch */
@@ -742,7 +805,8 @@ void fclaw2d_ghost_update_async(fclaw2d_global_t* glob,
 						maxfine,
 						sync_time,
 						time_interp,
-						parallel_mode);
+						parallel_mode,
+						physbc_mask);
 
 	fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_GHOSTFILL_STEP2]);
 
@@ -784,7 +848,8 @@ void fclaw2d_ghost_update_async(fclaw2d_global_t* glob,
 						maxlevel,
 						sync_time,
 						time_interp,
-						parallel_mode);
+						parallel_mode,
+						physbc_mask);
 
 	/* Interpolate */
 	interpolate_coarse2fine_ghost(glob,mincoarse, maxcoarse,
@@ -808,8 +873,9 @@ void fclaw2d_ghost_update_async(fclaw2d_global_t* glob,
 		   to adjacent fine grid.  But now, we need to apply physical BCs to fine grid.
 		   So we sweep over all grids to apply phys. BCs.  This is overkill, since
 		   only those fine grids with neighboring coarse grid patches on the parallel boundary
-		   are affected, but it is hard to see how to avoid this without some tedious
-		   checking.
+		   are affected.  With a ghost fill plan, we only visit patches with a physical
+		   boundary that are on the parallel boundary or are a local neighbor of one
+		   (see fclaw2d_ghost_fill_plan_t::physbc_refresh).
 	*/
 
 	/* Physical */
@@ -818,7 +884,8 @@ void fclaw2d_ghost_update_async(fclaw2d_global_t* glob,
 						maxlevel,
 						sync_time,
 						time_interp,
-						FCLAW2D_BOUNDARY_ALL);
+						FCLAW2D_BOUNDARY_ALL,
+						physbc_refresh);
 	fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_GHOSTFILL_STEP3]);
 
 	// Stop timing
@@ -829,6 +896,19 @@ void fclaw2d_ghost_update_async(fclaw2d_global_t* glob,
 	}
 }
 
+void fclaw2d_ghost_update_async(fclaw2d_global_t* glob,
+								int minlevel,
+								int maxlevel,
+								double sync_time,
+								int time_interp,
+								fclaw2d_timer_names_t running)
+{
+	fclaw2d_ghost_update_begin(glob,minlevel,maxlevel,sync_time,
+							   time_interp,running);
+	fclaw2d_ghost_update_end(glob,minlevel,maxlevel,sync_time,
+							 time_interp,running);
+}
+
 
 
 /* -----------------------------------------------------------------------
@@ -856,3 +936,168 @@ void fclaw2d_ghost_update(fclaw2d_global_t* glob,
 }
 
 
+/* -----------------------------------------------------------------------
+   Cached neighbor plan
+   ---------------------------------------------------------------------*/
+
+static
+void mark_exchange_halo(fclaw2d_domain_t *domain,
+						fclaw2d_ghost_fill_plan_t *plan,
+						int blockno,
+						fclaw2d_patch_t *patch)
+{
+	if (patch == NULL || fclaw2d_patch_is_ghost(patch))
+	{
+		return;
+	}
+	fclaw2d_block_t *block = domain->blocks + blockno;
+	int patchno = (int) (patch - block->patches);
+	FCLAW_ASSERT(0 <= patchno && patchno < block->num_patches);
+	plan->exchange_halo[block->num_patches_before + patchno] = 1;
+}
+
+void fclaw2d_ghost_fill_plan_build(fclaw2d_global_t* glob)
+{
+	fclaw2d_domain_t *domain = glob->domain;
+	fclaw2d_domain_data_t *ddata = fclaw2d_domain_get_data(domain);
+	fclaw2d_ghost_fill_plan_t *plan;
+	int i, j;
+
+	fclaw2d_ghost_fill_plan_destroy(domain);
+
+	plan = FCLAW_ALLOC_ZERO(fclaw2d_ghost_fill_plan_t,1);
+	plan->num_patches = domain->local_num_patches;
+	plan->faces = FCLAW_ALLOC(fclaw2d_ghost_fill_face_plan_t,
+							  FCLAW2D_NUMFACES*plan->num_patches);
+	plan->corners = FCLAW_ALLOC(fclaw2d_ghost_fill_corner_plan_t,
+								FCLAW2D_NUMCORNERS*plan->num_patches);
+
+	for (i = 0; i < domain->num_blocks; i++)
+	{
+		fclaw2d_block_t *block = domain->blocks + i;
+		for (j = 0; j < block->num_patches; j++)
+		{
+			fclaw2d_patch_t *patch = block->patches + j;
+			int patch_num = block->num_patches_before + j;
+			fclaw2d_face_neighbors_plan(glob,patch,i,j,
+										&plan->faces[FCLAW2D_NUMFACES*patch_num]);
+			fclaw2d_corner_neighbors_plan(glob,patch,i,j,
+										  &plan->corners[FCLAW2D_NUMCORNERS*patch_num]);
+		}
+	}
+
+	/* Patches that are read when boundary patches get their ghost cells
+	   filled before being sent */
+	plan->exchange_halo = FCLAW_ALLOC_ZERO(int,plan->num_patches);
+	for (i = 0; i < domain->num_blocks; i++)
+	{
+		fclaw2d_block_t *block = domain->blocks + i;
+		for (j = 0; j < block->num_patches; j++)
+		{
+			int patch_num = block->num_patches_before + j;
+			int k, ir;
+			if (!fclaw2d_patch_on_parallel_boundary(&block->patches[j]))
+			{
+				continue;
+			}
+			plan->exchange_halo[patch_num] = 1;
+			for (k = 0; k < FCLAW2D_NUMFACES; k++)
+			{
+				fclaw2d_ghost_fill_face_plan_t *fplan =
+					&plan->faces[FCLAW2D_NUMFACES*patch_num + k];
+				if (!fplan->is_interior_face)
+				{
+					continue;
+				}
+				int nb = fplan->neighbor_block_idx >= 0 ?
+						 fplan->neighbor_block_idx : i;
+				for (ir = 0; ir < FCLAW2D_NUMFACENEIGHBORS; ir++)
+				{
+					mark_exchange_halo(domain,plan,nb,fplan->neighbor_patches[ir]);
+				}
+			}
+			for (k = 0; k < FCLAW2D_NUMCORNERS; k++)
+			{
+				fclaw2d_ghost_fill_corner_plan_t *cplan =
+					&plan->corners[FCLAW2D_NUMCORNERS*patch_num + k];
+				if (cplan->is_interior_corner && cplan->has_neighbor)
+				{
+					mark_exchange_halo(domain,plan,cplan->corner_block_idx,
+									   cplan->corner_patch);
+				}
+			}
+		}
+	}
+
+	/* Patches with a physical boundary.  Those in the exchange halo can
+	   have ghost cells changed after the exchange and have to have their
+	   physical boundary conditions applied again. */
+	plan->physbc_patches = FCLAW_ALLOC_ZERO(int,plan->num_patches);
+	plan->physbc_refresh = FCLAW_ALLOC_ZERO(int,plan->num_patches);
+	for (i = 0; i < plan->num_patches; i++)
+	{
+		int k;
+		for (k = 0; k < FCLAW2D_NUMFACES; k++)
+		{
+			if (!plan->faces[FCLAW2D_NUMFACES*i + k].is_interior_face)
+			{
+				plan->physbc_patches[i] = 1;
+			}
+		}
+		plan->physbc_refresh[i] = plan->physbc_patches[i] &&
+								  plan->exchange_halo[i];
+	}
+
+	ddata->ghost_fill_plan = plan;
+}
+
+void fclaw2d_ghost_fill_plan_destroy(fclaw2d_domain_t* domain)
+{
+	fclaw2d_domain_data_t *ddata = fclaw2d_domain_get_data(domain);
+	fclaw2d_ghost_fill_plan_t *plan = ddata->ghost_fill_plan;
+	if (plan == NULL)
+	{
+		return;
+	}
+	FCLAW_FREE(plan->faces);
+	FCLAW_FREE(plan->corners);
+	FCLAW_FREE(plan->exchange_halo);
+	FCLAW_FREE(plan->physbc_patches);
+	FCLAW_FREE(plan->physbc_refresh);
+	FCLAW_FREE(plan);
+	ddata->ghost_fill_plan = NULL;
+}
+
+fclaw2d_ghost_fill_plan_t* fclaw2d_ghost_fill_plan_get(fclaw2d_domain_t* domain)
+{
+	fclaw2d_domain_data_t *ddata = fclaw2d_domain_get_data(domain);
+	return ddata == NULL ? NULL : ddata->ghost_fill_plan;
+}
+
+int fclaw2d_ghost_fill_exchange_mask(fclaw2d_domain_t* domain,
+									 fclaw2d_ghost_fill_parallel_mode_t mode,
+									 const int **mask, int *mask_value)
+{
+	fclaw2d_ghost_fill_plan_t *plan = fclaw2d_ghost_fill_plan_get(domain);
+
+	*mask = NULL;
+	*mask_value = 1;
+	if (mode == FCLAW2D_BOUNDARY_GHOST_ONLY)
+	{
+		if (plan != NULL)
+		{
+			*mask = plan->exchange_halo;
+		}
+	}
+	else if (mode == FCLAW2D_BOUNDARY_INTERIOR_ONLY)
+	{
+		if (plan == NULL)
+		{
+			/* Everything was in the halo */
+			return 0;
+		}
+		*mask = plan->exchange_halo;
+		*mask_value = 0;
+	}
+	return 1;
+}
@@ -83,6 +83,72 @@ typedef struct fclaw2d_exchange_info
 
 } fclaw2d_exchange_info_t;
 
+/**
+ * @brief Cached result of a neighbor search across one patch face.
+ *
+ * Filled in by fclaw2d_face_neighbors_plan and replayed by cb_face_fill.
+ */
+typedef struct fclaw2d_ghost_fill_face_plan
+{
+	int is_interior_face;        /**< Face is not on a physical boundary */
+	int is_block_face;           /**< Face is on a block boundary */
+	int neighbor_block_idx;      /**< -1 if neighbor is in the same block */
+	int neighbor_level;          /**< -1 (coarser), 0 (same size), 1 (finer) */
+	int fine_grid_pos;           /**< Position of this patch next to coarser neighbor */
+	int iface_neighbor;          /**< Face number seen from the neighbor */
+	struct fclaw2d_patch *neighbor_patches[2];
+	int transform[9];
+	int transform_finegrid[9];
+	int block_iface_finegrid;
+} fclaw2d_ghost_fill_face_plan_t;
+
+/**
+ * @brief Cached result of a neighbor search across one patch corner.
+ *
+ * Filled in by fclaw2d_corner_neighbors_plan and replayed by cb_corner_fill.
+ */
+typedef struct fclaw2d_ghost_fill_corner_plan
+{
+	int is_interior_corner;      /**< Corner is not on a physical boundary */
+	int is_block_corner;         /**< Corner is a block corner */
+	int block_iface;             /**< Block face the corner lies on, or -1 */
+	int has_neighbor;            /**< False for hanging nodes, 3-block corners */
+	int corner_block_idx;
+	int rcornerno;               /**< Corner number seen from the neighbor */
+	int neighbor_level;          /**< -1 (coarser), 0 (same size), 1 (finer) */
+	int block_corner_count;
+	struct fclaw2d_patch *corner_patch;
+	int has_transform;           /**< False if search did not set transforms */
+	int transform[9];
+	int transform_finegrid[9];
+	int block_iface_finegrid;
+} fclaw2d_ghost_fill_corner_plan_t;
+
+/**
+ * @brief Neighbor information for all local patches in a domain.
+ *
+ * The plan is built once after the neighbor types have been set
+ * (see fclaw2d_regrid_set_neighbor_types) and is valid until the domain
+ * is regridded or repartitioned.  Entries are indexed by the local patch
+ * number (block->num_patches_before + patchno).
+ */
+typedef struct fclaw2d_ghost_fill_plan
+{
+	int num_patches;
+	fclaw2d_ghost_fill_face_plan_t *faces;      /**< 4 entries per patch */
+	fclaw2d_ghost_fill_corner_plan_t *corners;  /**< 4 entries per patch */
+	/** 1 for patches on the parallel boundary and their local face and
+	    corner neighbors, 0 otherwise.  These patches have to be current
+	    before ghost patches are packed and sent. */
+	int *exchange_halo;
+	/** 1 for patches with a face on the physical boundary */
+	int *physbc_patches;
+	/** 1 for patches in physbc_patches that are also in the exchange halo.
+	    Only these can have ghost cells changed after the exchange, and
+	    need physical boundary conditions applied again. */
+	int *physbc_refresh;
+} fclaw2d_ghost_fill_plan_t;
+
 void cb_corner_fill(struct fclaw2d_domain *domain,
 					struct fclaw2d_patch *this_patch,
 					int this_block_idx,
@@ -151,6 +217,69 @@ void fclaw2d_face_neighbor_ghost(struct fclaw2d_global* glob,
 								 int maxlevel,
 								 int time_interp);
 
+/**
+ * @brief Build the ghost-fill plan for the current domain.
+ *
+ * Face and corner neighbor searches are done once for every local patch
+ * and stored with the domain.  Any existing plan is replaced.  Should be
+ * called after the neighbor types have been set.
+ */
+void fclaw2d_ghost_fill_plan_build(struct fclaw2d_global* glob);
+
+/**
+ * @brief Destroy the ghost-fill plan stored with a domain (if any).
+ */
+void fclaw2d_ghost_fill_plan_destroy(struct fclaw2d_domain* domain);
+
+/**
+ * @brief Get the ghost-fill plan for a domain
+ *
+ * @return The plan, or NULL if no plan has been built for this domain.
+ */
+fclaw2d_ghost_fill_plan_t* fclaw2d_ghost_fill_plan_get(struct fclaw2d_domain* domain);
+
+/**
+ * @brief Select patches according to their role in the ghost exchange
+ *
+ * FCLAW2D_BOUNDARY_GHOST_ONLY selects the exchange halo,
+ * FCLAW2D_BOUNDARY_INTERIOR_ONLY the remaining patches and any other mode
+ * all patches.  Without a plan, the halo is taken to be all patches.
+ *
+ * @param[out] mask NULL if all patches are selected, otherwise an array
+ *             indexed by local patch number
+ * @param[out] mask_value Selected patches have mask[i] == mask_value
+ * @return 0 if no patches are selected, 1 otherwise
+ */
+int fclaw2d_ghost_fill_exchange_mask(struct fclaw2d_domain* domain,
+									 fclaw2d_ghost_fill_parallel_mode_t mode,
+									 const int **mask, int *mask_value);
+
+/**
+ * @brief Start a ghost update
+ *
+ * Fills ghost cells of patches on the parallel boundary and starts sending
+ * ghost patches.  Patches not in the exchange halo (see
+ * fclaw2d_ghost_fill_plan_t) may be modified until the matching call to
+ * fclaw2d_ghost_update_end.  The two calls together are equivalent to
+ * fclaw2d_ghost_update.
+ */
+void fclaw2d_ghost_update_begin(struct fclaw2d_global* glob,
+								int minlevel,
+								int maxlevel,
+								double sync_time,
+								int time_interp,
+								fclaw2d_timer_names_t running);
+
+/**
+ * @brief Finish a ghost update started with fclaw2d_ghost_update_begin
+ */
+void fclaw2d_ghost_update_end(struct fclaw2d_global* glob,
+							  int minlevel,
+							  int maxlevel,
+							  double sync_time,
+							  int time_interp,
+							  fclaw2d_timer_names_t running);
+
 #ifdef __cplusplus
 #if 0
 {
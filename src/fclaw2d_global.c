@@ -48,6 +48,117 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <fclaw3d_map.h>
 #endif
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+/** One grow-only buffer per (thread, slot). */
+typedef struct fclaw2d_scratch_buffer
+{
+    double *data;
+    size_t count;
+}
+fclaw2d_scratch_buffer_t;
+
+/* Rows of SLOTS buffers, one row per thread.  Rows are allocated in
+   chunks that never move, so a thread finds its row without locking,
+   also while another thread adds a chunk. */
+#define SCRATCH_CHUNK_ROWS 64
+#define SCRATCH_MAX_CHUNKS 64
+
+struct fclaw2d_global_scratch
+{
+    fclaw2d_scratch_buffer_t *chunks[SCRATCH_MAX_CHUNKS];
+};
+
+#if defined(_OPENMP)
+/* Row of the calling thread, numbered on first use.  Unlike
+   omp_get_thread_num, this is unique among the threads of nested teams
+   and does not depend on the size of the current team. */
+static int scratch_thread_row = -1;
+#pragma omp threadprivate(scratch_thread_row)
+static int scratch_num_rows = 0;
+#endif
+
+static struct fclaw2d_global_scratch *
+global_scratch_new (void)
+{
+    return FCLAW_ALLOC_ZERO (struct fclaw2d_global_scratch, 1);
+}
+
+static void
+global_scratch_destroy (struct fclaw2d_global_scratch *scratch)
+{
+    int c, i;
+
+    for (c = 0; c < SCRATCH_MAX_CHUNKS; c++)
+    {
+        if (scratch->chunks[c] == NULL)
+        {
+            continue;
+        }
+        for (i = 0; i < SCRATCH_CHUNK_ROWS * FCLAW2D_GLOBAL_SCRATCH_SLOTS; i++)
+        {
+            FCLAW_FREE (scratch->chunks[c][i].data);
+        }
+        FCLAW_FREE (scratch->chunks[c]);
+    }
+    FCLAW_FREE (scratch);
+}
+
+double *
+fclaw2d_global_get_scratch (fclaw2d_global_t * glob, int slot, size_t count)
+{
+    struct fclaw2d_global_scratch *scratch = glob->scratch;
+    fclaw2d_scratch_buffer_t *chunk, *buf;
+    int row = 0;
+
+    FCLAW_ASSERT (scratch != NULL);
+    FCLAW_ASSERT (0 <= slot && slot < FCLAW2D_GLOBAL_SCRATCH_SLOTS);
+
+#if defined(_OPENMP)
+    if (scratch_thread_row < 0)
+    {
+#pragma omp atomic capture
+        scratch_thread_row = scratch_num_rows++;
+    }
+    row = scratch_thread_row;
+#endif
+    SC_CHECK_ABORTF (row < SCRATCH_CHUNK_ROWS * SCRATCH_MAX_CHUNKS,
+                     "Scratch memory for at most %d threads",
+                     SCRATCH_CHUNK_ROWS * SCRATCH_MAX_CHUNKS);
+
+#pragma omp atomic read
+    chunk = scratch->chunks[row / SCRATCH_CHUNK_ROWS];
+    if (chunk == NULL)
+    {
+#pragma omp critical(fclaw2d_global_scratch)
+        {
+            chunk = scratch->chunks[row / SCRATCH_CHUNK_ROWS];
+            if (chunk == NULL)
+            {
+                chunk = FCLAW_ALLOC_ZERO (fclaw2d_scratch_buffer_t,
+                                          SCRATCH_CHUNK_ROWS *
+                                          FCLAW2D_GLOBAL_SCRATCH_SLOTS);
+#pragma omp atomic write
+                scratch->chunks[row / SCRATCH_CHUNK_ROWS] = chunk;
+            }
+        }
+    }
+
+    /* Each thread only ever touches its own row, so no locking */
+    buf = &chunk[(row % SCRATCH_CHUNK_ROWS) * FCLAW2D_GLOBAL_SCRATCH_SLOTS
+                 + slot];
+    if (count > buf->count)
+    {
+        /* Contents need not survive, so skip the copy of a realloc */
+        FCLAW_FREE (buf->data);
+        buf->data = FCLAW_ALLOC (double, count);
+        buf->count = count;
+    }
+    return buf->data;
+}
+
 void
 fclaw2d_iterate_patch_cb
   (fclaw2d_domain_t *domain, fclaw2d_patch_t *patch,
@@ -103,8 +214,14 @@ fclaw2d_global_t* fclaw2d_global_new (void)
     glob->count_grids_local_boundary = 0;
     glob->count_single_step = 0;
     glob->count_elliptic_grids = 0;
+    glob->count_wire_bytes_saved = 0;
+    glob->count_patch_cost = 0;
     glob->curr_time = 0;
+    glob->tag_in_update = 0;
+    glob->tag_in_update_time = 0;
+    glob->partition_skipped = 0;
     glob->cont = NULL;
+    glob->scratch = global_scratch_new ();
 
 #ifndef P4_TO_P8
     /* think about how this can work independent of dimension */
@@ -246,6 +363,7 @@ fclaw2d_global_destroy (fclaw2d_global_t * glob)
     if(glob->pkg_container != NULL) fclaw_package_container_destroy ((fclaw_package_container_t *)glob->pkg_container);
     if(glob->vtables != NULL) fclaw_pointer_map_destroy (glob->vtables);
     if(glob->options != NULL) fclaw_pointer_map_destroy (glob->options);
+    if(glob->scratch != NULL) global_scratch_destroy (glob->scratch);
 
 #ifndef P4_TO_P8
     FCLAW_FREE (glob->acc);
@@ -298,6 +416,58 @@ void fclaw2d_global_iterate_level_mthread (fclaw2d_global_t * glob, int level,
     fclaw2d_domain_iterate_level_mthread (glob->domain, level,pcb,&g);
 }
 
+void fclaw2d_global_iterate_patches_mthread (fclaw2d_global_t * glob,
+                                             fclaw2d_patch_callback_t pcb,
+                                             void *user)
+{
+    fclaw2d_global_iterate_t g;
+    g.glob = glob;
+    g.user = user;
+    fclaw2d_domain_iterate_patches_mthread (glob->domain, pcb, &g);
+}
+
+void fclaw2d_global_iterate_adapted_mthread (fclaw2d_global_t * glob,
+                                             fclaw2d_domain_t* new_domain,
+                                             fclaw2d_match_callback_t mcb,
+                                             void *user)
+{
+    fclaw2d_global_iterate_t g;
+    g.glob = glob;
+    g.user = user;
+    fclaw2d_domain_iterate_adapted_mthread (glob->domain, new_domain, mcb, &g);
+}
+
+void fclaw2d_global_iterate_level_reduce (fclaw2d_global_t * glob, int level,
+                                          fclaw2d_patch_reduce_callback_t pcb,
+                                          void *user, void *result,
+                                          size_t result_size,
+                                          fclaw2d_reduce_combine_t combine)
+{
+    fclaw2d_global_iterate_t g;
+    g.glob = glob;
+    g.user = user;
+    fclaw2d_domain_iterate_level_reduce (glob->domain, level, pcb, &g,
+                                         result, result_size, combine);
+}
+
+void fclaw2d_global_iterate_level_batched (fclaw2d_global_t * glob, int level,
+                                           int batch_size,
+                                           const int *patch_mask,
+                                           int mask_value,
+                                           fclaw2d_patch_batch_callback_t pcb,
+                                           void *user, void *result,
+                                           size_t result_size,
+                                           fclaw2d_reduce_combine_t combine)
+{
+    fclaw2d_global_iterate_t g;
+    g.glob = glob;
+    g.user = user;
+    fclaw2d_domain_iterate_level_batched (glob->domain, level, batch_size,
+                                          patch_mask, mask_value,
+                                          pcb, &g, result, result_size,
+                                          combine);
+}
+
 void fclaw2d_global_iterate_partitioned (fclaw2d_global_t * glob,
                                          fclaw2d_domain_t * new_domain,
                                          fclaw2d_transfer_callback_t tcb,
@@ -309,6 +479,18 @@ void fclaw2d_global_iterate_partitioned (fclaw2d_global_t * glob,
     fclaw2d_domain_iterate_partitioned (glob->domain,new_domain,tcb,&g);
 }
 
+void fclaw2d_global_iterate_partitioned_mthread (fclaw2d_global_t * glob,
+                                                 fclaw2d_domain_t * new_domain,
+                                                 fclaw2d_transfer_callback_t tcb,
+                                                 void *user)
+{
+    fclaw2d_global_iterate_t g;
+    g.glob = glob;
+    g.user = user;
+    fclaw2d_domain_iterate_partitioned_mthread (glob->domain, new_domain,
+                                                tcb, &g);
+}
+
 void fclaw2d_global_options_store (fclaw2d_global_t* glob, const char* key, void* options)
 {
     
@@ -28,6 +28,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <forestclaw2d.h>  /* Needed to declare callbacks (below) */
 #include <fclaw2d_map.h>   /* Needed to store the map context */
+#include <fclaw2d_domain.h>  /* Needed to declare reduction callbacks */
 
 #include <fclaw_timer.h>   /* Needed to create statically allocated array of timers */
 
@@ -66,12 +67,22 @@ struct fclaw2d_global
     int count_grids_per_proc;
     int count_grids_remote_boundary;
     int count_grids_local_boundary;
+    double count_wire_bytes_saved;  /**< Bytes saved by compact ghost/partition packing */
+    double count_patch_cost;  /**< Local patch cost per coarse step at last partition */
     fclaw2d_timer_t timers[FCLAW2D_TIMER_COUNT];
 
     /* Time at start of each subcycled time step */
     double curr_time;
     double curr_dt;
 
+    /** Solvers tag patches for refinement in the update that ends at
+        tag_in_update_time, since the run loop regrids right after it */
+    int tag_in_update;
+    double tag_in_update_time;
+
+    /** Regrids since the last partition (see fclaw2d_partition_needed) */
+    int partition_skipped;
+
     sc_MPI_Comm mpicomm;
     int mpisize;              /**< Size of communicator. */
     int mpirank;              /**< Rank of this process in \b mpicomm. */
@@ -95,6 +106,9 @@ struct fclaw2d_global
            that this file does not need to know about gauges at all? */
     struct fclaw_gauge_info* gauge_info;
 
+    /** Per-thread scratch memory, see fclaw2d_global_get_scratch. */
+    struct fclaw2d_global_scratch *scratch;
+
     void *user;
 };
 
@@ -113,6 +127,7 @@ struct fclaw2d_domain;
 struct fclaw2d_map_context;
 struct fclaw_package_container;
 struct fclaw2d_diagnostics_accumulator;
+struct fclaw2d_global_scratch;
 
 /** Allocate a new global structure. */
 fclaw2d_global_t* fclaw2d_global_new (void);
@@ -122,6 +137,27 @@ fclaw2d_global_t* fclaw2d_global_new_comm (sc_MPI_Comm mpicomm,
 
 void fclaw2d_global_destroy (fclaw2d_global_t * glob);
 
+/** Number of scratch buffers each thread may hold at the same time. */
+#define FCLAW2D_GLOBAL_SCRATCH_SLOTS 8
+
+/** Borrow a scratch buffer for the calling thread.
+ * Solver step routines use this in place of allocating and freeing
+ * their work arrays for every patch.  Each (thread, slot) pair owns one
+ * buffer that grows to the largest size requested and is reused after
+ * that; it is released in fclaw2d_global_destroy.  Threads of nested or
+ * later, larger teams get buffers of their own.  The contents are
+ * undefined on return and remain valid until the same thread asks for
+ * the same slot again.
+ * \param [in] glob    Global context.
+ * \param [in] slot    Buffer index in [0, FCLAW2D_GLOBAL_SCRATCH_SLOTS).
+ *                     Use distinct slots for buffers that are live
+ *                     simultaneously.
+ * \param [in] count   Minimum number of doubles required.
+ * \return             Buffer of at least \a count doubles.
+ */
+double *fclaw2d_global_get_scratch (fclaw2d_global_t * glob, int slot,
+                                    size_t count);
+
 void fclaw2d_global_store_domain (fclaw2d_global_t* glob,
                                   struct fclaw2d_domain* domain);
 
@@ -169,6 +205,40 @@ void fclaw2d_global_iterate_adapted (fclaw2d_global_t * glob,
 void fclaw2d_global_iterate_level_mthread (fclaw2d_global_t * glob, int level,
                                            fclaw2d_patch_callback_t pcb, void *user);
 
+void fclaw2d_global_iterate_patches_mthread (fclaw2d_global_t * glob,
+                                             fclaw2d_patch_callback_t pcb,
+                                             void *user);
+
+void fclaw2d_global_iterate_adapted_mthread (fclaw2d_global_t * glob,
+                                             struct fclaw2d_domain* new_domain,
+                                             fclaw2d_match_callback_t mcb,
+                                             void *user);
+
+void fclaw2d_global_iterate_partitioned_mthread (fclaw2d_global_t * glob,
+                                                 struct fclaw2d_domain * new_domain,
+                                                 fclaw2d_transfer_callback_t tcb,
+                                                 void *user);
+
+/** Level iteration with thread-local reductions, see
+ * fclaw2d_domain_iterate_level_reduce.  The callback receives a
+ * fclaw2d_global_iterate_t as user argument. */
+void fclaw2d_global_iterate_level_reduce (fclaw2d_global_t * glob, int level,
+                                          fclaw2d_patch_reduce_callback_t pcb,
+                                          void *user, void *result,
+                                          size_t result_size,
+                                          fclaw2d_reduce_combine_t combine);
+
+/** Batched level iteration, see fclaw2d_domain_iterate_level_batched.
+ * The callback receives a fclaw2d_global_iterate_t as user argument. */
+void fclaw2d_global_iterate_level_batched (fclaw2d_global_t * glob, int level,
+                                           int batch_size,
+                                           const int *patch_mask,
+                                           int mask_value,
+                                           fclaw2d_patch_batch_callback_t pcb,
+                                           void *user, void *result,
+                                           size_t result_size,
+                                           fclaw2d_reduce_combine_t combine);
+
 void fclaw2d_global_iterate_partitioned (fclaw2d_global_t * glob,
                                          struct fclaw2d_domain * new_domain,
                                          fclaw2d_transfer_callback_t tcb,
@@ -33,6 +33,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <initializer_list>
 #include <vector>
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 TEST_CASE("fclaw2d_global_pack with no options")
 {
 
@@ -375,6 +379,57 @@ TEST_CASE("fclaw2d_global_unset_global")
 #endif
 }
 
+TEST_CASE("fclaw2d_global_get_scratch reuses and grows buffers")
+{
+	fclaw2d_global_t* glob = fclaw2d_global_new();
+
+	double *a = fclaw2d_global_get_scratch(glob, 0, 100);
+	double *b = fclaw2d_global_get_scratch(glob, 1, 100);
+	REQUIRE_NE(a, nullptr);
+	CHECK_NE(a, b);
+
+	/* same or smaller request hands back the same buffer */
+	CHECK_EQ(fclaw2d_global_get_scratch(glob, 0, 100), a);
+	CHECK_EQ(fclaw2d_global_get_scratch(glob, 0, 10), a);
+
+	/* a larger request is usable in full */
+	double *c = fclaw2d_global_get_scratch(glob, 0, 1000);
+	c[999] = 1.0;
+	CHECK_EQ(fclaw2d_global_get_scratch(glob, 0, 1000), c);
+
+	fclaw2d_global_destroy(glob);
+}
+
+#if defined(_OPENMP)
+
+TEST_CASE("fclaw2d_global_get_scratch gives threads of larger and nested teams their own buffers")
+{
+	fclaw2d_global_t* glob = fclaw2d_global_new();
+	fclaw2d_global_get_scratch(glob, 0, 10);
+
+	int outer = omp_get_max_threads() + 2;
+	int errors = 0;
+	int max_active_levels = omp_get_max_active_levels();
+	omp_set_max_active_levels(2);
+#pragma omp parallel num_threads(outer) reduction(+:errors)
+	{
+#pragma omp parallel num_threads(2) reduction(+:errors)
+		{
+			double id = 2*omp_get_ancestor_thread_num(1) + omp_get_thread_num();
+			double *a = fclaw2d_global_get_scratch(glob, 0, 10);
+			a[9] = id;
+#pragma omp barrier
+			errors += a[9] != id;
+		}
+	}
+	omp_set_max_active_levels(max_active_levels);
+	CHECK_EQ(errors, 0);
+
+	fclaw2d_global_destroy(glob);
+}
+
+#endif
+
 #ifdef FCLAW_ENABLE_DEBUG
 
 TEST_CASE("fclaw2d_global_set_global twice fails")
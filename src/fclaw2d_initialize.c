@@ -130,6 +130,9 @@ void fclaw2d_initialize(fclaw2d_global_t *glob)
                                  NULL);
     fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_REGRID_BUILD]);
 
+    /* Optionally store patch data level by level */
+    fclaw2d_patch_pack_levels(glob);
+
     /* Set up ghost patches */
     fclaw2d_exchange_setup(glob,FCLAW2D_TIMER_INIT);
 
@@ -210,6 +213,8 @@ void fclaw2d_initialize(fclaw2d_global_t *glob)
                 /* Repartition domain to new processors.    */
                 fclaw2d_partition_domain(glob,FCLAW2D_TIMER_INIT);
 
+                fclaw2d_patch_pack_levels(glob);
+
                 /* Set up ghost patches.  This probably doesn't need to be done
                    each time we add a new level. */
                 fclaw2d_exchange_setup(glob,FCLAW2D_TIMER_INIT);
@@ -217,6 +222,15 @@ void fclaw2d_initialize(fclaw2d_global_t *glob)
                 /* This is normally called from regrid, once the initial domain
                    has been set up */
                 fclaw2d_regrid_set_neighbor_types(glob);
+
+                /* Patches may have been partitioned without their ghost
+                   cells; tagging the next level needs them */
+                if (fclaw_opt->init_ghostcell)
+                {
+                    fclaw2d_ghost_update(glob,(*domain)->global_minlevel,
+                                         (*domain)->global_maxlevel,0.0,
+                                         time_interp,FCLAW2D_TIMER_INIT);
+                }
             }
             else
             {
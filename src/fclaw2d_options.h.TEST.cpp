@@ -102,11 +102,15 @@ TEST_CASE("fclaw2d_options packing/unpacking")
 	opts->regrid_interval = 5;
 	opts->smooth_refine = 2;
 	opts->refine_threshold = 3.0;
+	opts->tag_reuse_tolerance = 1e-3;
+	opts->tag_in_update = 1;
 	opts->time_sync = 0;
 	opts->output_gauges = 1;
 	opts->gauge_buffer_length = 300;
 	opts->output_rays = 2;
 	opts->manifold = 2;
+	opts->share_metric = 1;
+	opts->metric_cache_size = 64;
 	opts->mi = 3;
 	opts->mj = 4;
 	opts->periodic_x = 0;
@@ -116,6 +120,8 @@ TEST_CASE("fclaw2d_options packing/unpacking")
 	opts->coarsen_delay = 3;
 	opts->init_ghostcell = 0;
 	opts->advance_one_step = 1;
+	opts->overlap_ghost_exchange = 1;
+	opts->speculative_cfl = 1;
 	opts->outstyle_uses_maxlevel = 2;
 	opts->timeinterp2fillghost = 3;
 	opts->scale_string = "blah";
@@ -154,6 +160,11 @@ TEST_CASE("fclaw2d_options packing/unpacking")
 	opts->prefix = "jdsjkl";
 	opts->vtkspace = 0.328;
 	opts->weighted_partition = 0;
+	opts->partition_cost = 1;
+	opts->partition_imbalance = 0.05;
+	opts->partition_max_skip = 8;
+	opts->refine_on_destination = 1;
+	opts->partition_compress = 1;
 	opts->is_registered = 1;
 	opts->logging_prefix = "werqreqw";
 	opts->is_unpacked = false;
@@ -199,11 +210,15 @@ TEST_CASE("fclaw2d_options packing/unpacking")
 	CHECK_EQ(opts->regrid_interval                     , output_opts->regrid_interval);
 	CHECK_EQ(opts->smooth_refine                       , output_opts->smooth_refine);
 	CHECK_EQ(opts->refine_threshold                    , output_opts->refine_threshold);
+	CHECK_EQ(opts->tag_reuse_tolerance                 , output_opts->tag_reuse_tolerance);
+	CHECK_EQ(opts->tag_in_update                       , output_opts->tag_in_update);
 	CHECK_EQ(opts->time_sync                           , output_opts->time_sync);
 	CHECK_EQ(opts->output_gauges                       , output_opts->output_gauges);
 	CHECK_EQ(opts->gauge_buffer_length                 , output_opts->gauge_buffer_length);
 	CHECK_EQ(opts->output_rays                         , output_opts->output_rays);
 	CHECK_EQ(opts->manifold                            , output_opts->manifold);
+	CHECK_EQ(opts->share_metric                        , output_opts->share_metric);
+	CHECK_EQ(opts->metric_cache_size                   , output_opts->metric_cache_size);
 	CHECK_EQ(opts->mi                                  , output_opts->mi);
 	CHECK_EQ(opts->mj                                  , output_opts->mj);
 	CHECK_EQ(opts->periodic_x                          , output_opts->periodic_x);
@@ -213,6 +228,8 @@ TEST_CASE("fclaw2d_options packing/unpacking")
 	CHECK_EQ(opts->coarsen_delay                       , output_opts->coarsen_delay);
 	CHECK_EQ(opts->init_ghostcell                      , output_opts->init_ghostcell);
 	CHECK_EQ(opts->advance_one_step                    , output_opts->advance_one_step);
+	CHECK_EQ(opts->overlap_ghost_exchange              , output_opts->overlap_ghost_exchange);
+	CHECK_EQ(opts->speculative_cfl                     , output_opts->speculative_cfl);
 	CHECK_EQ(opts->outstyle_uses_maxlevel              , output_opts->outstyle_uses_maxlevel);
 	CHECK_EQ(opts->timeinterp2fillghost                , output_opts->timeinterp2fillghost);
 
@@ -279,6 +296,11 @@ TEST_CASE("fclaw2d_options packing/unpacking")
 
 	CHECK_EQ(opts->vtkspace                            , output_opts->vtkspace);
 	CHECK_EQ(opts->weighted_partition                  , output_opts->weighted_partition);
+	CHECK_EQ(opts->partition_cost                      , output_opts->partition_cost);
+	CHECK_EQ(opts->partition_imbalance                 , output_opts->partition_imbalance);
+	CHECK_EQ(opts->partition_max_skip                  , output_opts->partition_max_skip);
+	CHECK_EQ(opts->refine_on_destination               , output_opts->refine_on_destination);
+	CHECK_EQ(opts->partition_compress                  , output_opts->partition_compress);
 	CHECK_EQ(opts->is_registered                       , output_opts->is_registered);
 
 	CHECK_NE(opts->logging_prefix                      , output_opts->logging_prefix);
@@ -77,7 +77,9 @@ void  cb_partition_transfer(fclaw2d_domain_t * old_domain,
 
         new_patch->user = old_patch->user;
         old_patch->user = NULL;
+#pragma omp atomic
         ++ddata_old->count_delete_patch;
+#pragma omp atomic
         ++ddata_new->count_set_patch;
     }
     else
@@ -98,7 +100,9 @@ void  cb_partition_transfer(fclaw2d_domain_t * old_domain,
         /* Reason for the following two lines: the glob contains the old domain 
         which is incremented in ddata_old  but we really want to increment the 
         new domain. */
+#pragma omp atomic
         --ddata_old->count_set_patch;
+#pragma omp atomic
         ++ddata_new->count_set_patch;
 
 
@@ -106,48 +110,758 @@ void  cb_partition_transfer(fclaw2d_domain_t * old_domain,
 }
 
 
+/* ------------------------ Refinement on the destination -----------------------------
+
+   With refine-on-destination, fine patches waiting for interpolation
+   (fclaw2d_patch_defer_interpolate2fine) are sent as their coarse patch,
+   stored with the first fine patch, and the other siblings are sent
+   without data.  Siblings stay together in the partition.  Only patches
+   that change owner are packed, so the transfer uses varying sizes. */
+
+typedef struct partition_variable
+{
+    int unchanged_first;    /* old local patches that stay local */
+    int unchanged_last;
+    size_t psize;
+    int compress;           /* send compressed records */
+    int *sizes;             /* bytes per old (pack) or new (unpack) patch */
+    size_t *offsets;        /* start of each patch in data, so that patches
+                               can be packed and unpacked concurrently */
+    char *data;
+} partition_variable_t;
+
+/* ------------------------ Compressed partition records -----------------------------
+
+   With partition-compress, a packed patch is sent as a record that starts
+   with a partition_record_t.  The bytes of the packed doubles are shuffled
+   so that bytes of equal significance are adjacent, which turns the sign
+   and exponent bytes of smooth data and constant regions into runs, and
+   then run-length encoded.  Records that would not shrink are sent raw.
+   The encoding is lossless. */
+
+typedef struct partition_record
+{
+    int raw_size;           /* bytes of the packed patch */
+    int encoded;            /* 0 if the packed bytes follow as they are */
+} partition_record_t;
+
+/* Scratch slots for the packed and the shuffled bytes of a patch */
+#define PARTITION_SCRATCH_RAW      (FCLAW2D_GLOBAL_SCRATCH_SLOTS - 1)
+#define PARTITION_SCRATCH_SHUFFLE  (FCLAW2D_GLOBAL_SCRATCH_SLOTS - 2)
+
+static
+char* partition_scratch(fclaw2d_global_t *glob, int slot, size_t bytes)
+{
+    size_t count = (bytes + sizeof(double) - 1)/sizeof(double);
+    return (char*) fclaw2d_global_get_scratch(glob,slot,count);
+}
+
+/* Group byte k of every double together; trailing bytes stay in place */
+static
+void partition_shuffle(const unsigned char *in, unsigned char *out,
+                       size_t n, int unshuffle)
+{
+    size_t m = n/sizeof(double);
+    for (size_t k = 0; k < m; k++)
+    {
+        for (size_t b = 0; b < sizeof(double); b++)
+        {
+            if (unshuffle)
+            {
+                out[k*sizeof(double) + b] = in[b*m + k];
+            }
+            else
+            {
+                out[b*m + k] = in[k*sizeof(double) + b];
+            }
+        }
+    }
+    size_t tail = m*sizeof(double);
+    memcpy(out + tail,in + tail,n - tail);
+}
+
+/* Run-length encoding: a count byte c < 128 is followed by c + 1 literal
+   bytes, a count byte c >= 128 by one byte to repeat c - 125 times.
+   Returns the encoded size, or 0 if it would exceed max_out. */
+static
+size_t partition_rle_encode(const unsigned char *in, size_t n,
+                            unsigned char *out, size_t max_out)
+{
+    size_t i = 0, o = 0;
+    while (i < n)
+    {
+        size_t run = 1;
+        while (i + run < n && run < 130 && in[i + run] == in[i])
+        {
+            run++;
+        }
+        if (run >= 3)
+        {
+            if (o + 2 > max_out)
+            {
+                return 0;
+            }
+            out[o++] = (unsigned char) (run + 125);
+            out[o++] = in[i];
+            i += run;
+            continue;
+        }
+
+        /* Literals up to the next run of three equal bytes */
+        size_t len = 0;
+        while (i + len < n && len < 128)
+        {
+            if (i + len + 2 < n && in[i + len] == in[i + len + 1] &&
+                in[i + len] == in[i + len + 2])
+            {
+                break;
+            }
+            len++;
+        }
+        if (o + 1 + len > max_out)
+        {
+            return 0;
+        }
+        out[o++] = (unsigned char) (len - 1);
+        memcpy(out + o,in + i,len);
+        o += len;
+        i += len;
+    }
+    return o;
+}
+
+static
+void partition_rle_decode(const unsigned char *in, unsigned char *out,
+                          size_t n)
+{
+    size_t i = 0, o = 0;
+    while (o < n)
+    {
+        int c = in[i++];
+        if (c < 128)
+        {
+            memcpy(out + o,in + i,c + 1);
+            i += c + 1;
+            o += c + 1;
+        }
+        else
+        {
+            memset(out + o,in[i++],c - 125);
+            o += c - 125;
+        }
+    }
+    FCLAW_ASSERT(o == n);
+}
+
+/* Write the record of raw_size packed bytes to out, which has room for
+   the header and the raw bytes.  Returns the size of the record. */
+static
+int partition_record_encode(fclaw2d_global_t *glob,
+                            const char *raw, int raw_size, char *out)
+{
+    partition_record_t header;
+    header.raw_size = raw_size;
+
+    unsigned char *shuffled = (unsigned char*)
+        partition_scratch(glob,PARTITION_SCRATCH_SHUFFLE,raw_size);
+    partition_shuffle((const unsigned char*) raw,shuffled,raw_size,0);
+    size_t encoded_size =
+        partition_rle_encode(shuffled,raw_size,
+                             (unsigned char*) out + sizeof(header),
+                             raw_size - 1);
+    header.encoded = encoded_size > 0;
+    if (!header.encoded)
+    {
+        memcpy(out + sizeof(header),raw,raw_size);
+        encoded_size = raw_size;
+    }
+    memcpy(out,&header,sizeof(header));
+    return (int) (sizeof(header) + encoded_size);
+}
+
+/* Decode a record into scratch memory.  Returns the packed bytes. */
+static
+char* partition_record_decode(fclaw2d_global_t *glob,
+                              const char *record, int *raw_size)
+{
+    partition_record_t header;
+    memcpy(&header,record,sizeof(header));
+    record += sizeof(header);
+
+    char *raw = partition_scratch(glob,PARTITION_SCRATCH_RAW,header.raw_size);
+    if (header.encoded)
+    {
+        unsigned char *shuffled = (unsigned char*)
+            partition_scratch(glob,PARTITION_SCRATCH_SHUFFLE,header.raw_size);
+        partition_rle_decode((const unsigned char*) record,shuffled,
+                             header.raw_size);
+        partition_shuffle(shuffled,(unsigned char*) raw,header.raw_size,1);
+    }
+    else
+    {
+        memcpy(raw,record,header.raw_size);
+    }
+    *raw_size = header.raw_size;
+    return raw;
+}
+
+static
+size_t partition_variable_offsets(partition_variable_t *pv, int num_patches)
+{
+    size_t total = 0;
+    pv->offsets = FCLAW_ALLOC(size_t,num_patches);
+    for (int i = 0; i < num_patches; i++)
+    {
+        pv->offsets[i] = total;
+        total += pv->sizes[i];
+    }
+    return total;
+}
+
+static
+int partition_variable_size(fclaw2d_global_t *glob,
+                            fclaw2d_patch_t *patch,
+                            const partition_variable_t *pv,
+                            int patch_num)
+{
+    if (pv->unchanged_first <= patch_num && patch_num < pv->unchanged_last)
+    {
+        return 0;
+    }
+    if (fclaw2d_patch_get_deferred_parent(glob,patch) != NULL)
+    {
+        return (int) (sizeof(fclaw2d_patch_t) + pv->psize);
+    }
+    return fclaw2d_patch_is_deferred(glob,patch) ? 0 : (int) pv->psize;
+}
+
+static
+void cb_partition_size_variable(fclaw2d_domain_t *domain,
+                                fclaw2d_patch_t *patch,
+                                int blockno,
+                                int patchno,
+                                void *user)
+{
+    fclaw2d_global_iterate_t *g = (fclaw2d_global_iterate_t *) user;
+    partition_variable_t *pv = (partition_variable_t*) g->user;
+
+    int patch_num = domain->blocks[blockno].num_patches_before + patchno;
+    int size = partition_variable_size(g->glob,patch,pv,patch_num);
+    if (pv->compress && size > 0)
+    {
+        /* Room for a record that is sent raw */
+        size += sizeof(partition_record_t);
+    }
+    pv->sizes[patch_num] = size;
+}
+
+static
+void cb_partition_pack_variable(fclaw2d_domain_t *domain,
+                                fclaw2d_patch_t *patch,
+                                int blockno,
+                                int patchno,
+                                void *user)
+{
+    fclaw2d_global_iterate_t *g = (fclaw2d_global_iterate_t *) user;
+    partition_variable_t *pv = (partition_variable_t*) g->user;
+
+    int patch_num = domain->blocks[blockno].num_patches_before + patchno;
+    int size = pv->sizes[patch_num];
+    if (size == 0)
+    {
+        return;
+    }
+
+    char *pack_data_here = pv->data + pv->offsets[patch_num];
+    if (pv->compress)
+    {
+        /* Pack into scratch memory and encode into the record below */
+        size -= sizeof(partition_record_t);
+        pack_data_here = partition_scratch(g->glob,PARTITION_SCRATCH_RAW,size);
+    }
+
+    fclaw2d_patch_t *parent = fclaw2d_patch_get_deferred_parent(g->glob,patch);
+    if (parent == NULL)
+    {
+        fclaw2d_patch_partition_pack(g->glob,patch,blockno,patchno,
+                                     pack_data_here);
+    }
+    else
+    {
+        /* Send the coarse patch with its geometry instead of the fine patches */
+        memcpy(pack_data_here,parent,sizeof(fclaw2d_patch_t));
+        fclaw2d_patch_partition_pack(g->glob,parent,blockno,patchno,
+                                     pack_data_here + sizeof(fclaw2d_patch_t));
+
+        parent = fclaw2d_patch_take_deferred_parent(g->glob,patch);
+        fclaw2d_patch_data_delete(g->glob,parent);
+        FCLAW_FREE(parent);
+    }
+
+    if (pv->compress)
+    {
+        int record_size =
+            partition_record_encode(g->glob,pack_data_here,size,
+                                    pv->data + pv->offsets[patch_num]);
+        pv->sizes[patch_num] = record_size;
+#pragma omp atomic
+        g->glob->count_wire_bytes_saved += size - record_size;
+    }
+}
+
+static
+void cb_partition_transfer_variable(fclaw2d_domain_t * old_domain,
+                                    fclaw2d_patch_t * old_patch,
+                                    fclaw2d_domain_t * new_domain,
+                                    fclaw2d_patch_t * new_patch,
+                                    int blockno,
+                                    int old_patchno, int new_patchno,
+                                    void *user)
+{
+    fclaw2d_global_iterate_t *g = (fclaw2d_global_iterate_t *) user;
+    partition_variable_t *pv = (partition_variable_t*) g->user;
+    fclaw2d_domain_data_t *ddata_old = fclaw2d_domain_get_data (old_domain);
+    fclaw2d_domain_data_t *ddata_new = fclaw2d_domain_get_data (new_domain);
+
+    if (old_patch != NULL)
+    {
+        new_patch->user = old_patch->user;
+        old_patch->user = NULL;
+#pragma omp atomic
+        ++ddata_old->count_delete_patch;
+#pragma omp atomic
+        ++ddata_new->count_set_patch;
+        if (fclaw2d_patch_get_deferred_parent(g->glob,new_patch) != NULL)
+        {
+            /* The coarse patch moves along with the first fine patch */
+#pragma omp atomic
+            ++ddata_old->count_delete_patch;
+#pragma omp atomic
+            ++ddata_new->count_set_patch;
+        }
+        return;
+    }
+
+    fclaw2d_block_t *this_block = &new_domain->blocks[blockno];
+    int patch_num = this_block->num_patches_before + new_patchno;
+    int size = pv->sizes[patch_num];
+    char *unpack_data_from_here = pv->data + pv->offsets[patch_num];
+    if (pv->compress && size > 0)
+    {
+        unpack_data_from_here =
+            partition_record_decode(g->glob,unpack_data_from_here,&size);
+    }
+
+    /* As in cb_partition_transfer, glob still holds the old domain */
+#pragma omp atomic
+    --ddata_old->count_set_patch;
+#pragma omp atomic
+    ++ddata_new->count_set_patch;
+
+    if (size == (int) pv->psize)
+    {
+        fclaw2d_patch_partition_unpack(g->glob,new_domain,new_patch,
+                                       blockno,new_patchno,
+                                       unpack_data_from_here);
+        return;
+    }
+
+    /* A fine patch to be interpolated after the partition */
+    fclaw2d_build_mode_t build_mode = FCLAW2D_BUILD_FOR_UPDATE;
+    fclaw2d_patch_build(g->glob,new_patch,blockno,new_patchno,
+                        (void*) &build_mode);
+    if (size == 0)
+    {
+        return;
+    }
+
+    FCLAW_ASSERT(size == (int) (sizeof(fclaw2d_patch_t) + pv->psize));
+    fclaw2d_patch_t *parent = FCLAW_ALLOC(fclaw2d_patch_t,1);
+    memcpy(parent,unpack_data_from_here,sizeof(fclaw2d_patch_t));
+    parent->user = NULL;
+    fclaw2d_patch_partition_unpack(g->glob,new_domain,parent,
+                                   blockno,new_patchno,
+                                   unpack_data_from_here + sizeof(fclaw2d_patch_t));
+#pragma omp atomic
+    --ddata_old->count_set_patch;
+#pragma omp atomic
+    ++ddata_new->count_set_patch;
+
+    fclaw2d_patch_set_deferred_parent(g->glob,parent,new_patch);
+}
+
+/* Pack the patches that change owner, send them and unpack them into the
+   partitioned domain.  Called after fclaw2d_domain_partition. */
+static
+void partition_transfer_variable(fclaw2d_global_t *glob,
+                                 fclaw2d_domain_t *domain_partitioned,
+                                 const int64_t *old_offsets,
+                                 fclaw2d_timer_names_t running)
+{
+    fclaw2d_domain_t *domain = glob->domain;
+    partition_variable_t pv;
+
+    int uf, ul, uof;
+    fclaw2d_domain_partition_unchanged(domain_partitioned,&uf,&ul,&uof);
+    pv.unchanged_first = uof;
+    pv.unchanged_last = uof + ul;
+    pv.psize = fclaw2d_patch_partition_packsize(glob);
+    pv.compress = fclaw2d_get_options(glob)->partition_compress;
+
+    pv.sizes = FCLAW_ALLOC(int,domain->local_num_patches);
+    fclaw2d_global_iterate_patches(glob,cb_partition_size_variable,&pv);
+    size_t total = partition_variable_offsets(&pv,domain->local_num_patches);
+    pv.data = FCLAW_ALLOC(char,total);
+#if defined(_OPENMP)
+    /* Every patch packs into its own slot and frees only its own parent */
+    fclaw2d_global_iterate_patches_mthread(glob,cb_partition_pack_variable,&pv);
+#else
+    fclaw2d_global_iterate_patches(glob,cb_partition_pack_variable,&pv);
+#endif
+    if (pv.compress)
+    {
+        /* Close the gaps left by records shorter than their slots */
+        size_t offset = 0;
+        for (int i = 0; i < domain->local_num_patches; i++)
+        {
+            memmove(pv.data + offset,pv.data + pv.offsets[i],pv.sizes[i]);
+            offset += pv.sizes[i];
+        }
+    }
+
+    fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_PARTITION_BUILD]);
+    fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_PARTITION]);
+    if (running != FCLAW2D_TIMER_NONE)
+    {
+        fclaw2d_timer_stop (&glob->timers[running]);
+    }
+    fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_PARTITION_COMM]);
+
+    void *dest_data;
+    int *dest_sizes;
+    fclaw2d_domain_transfer_after_partition(domain_partitioned,old_offsets,
+                                            pv.data,pv.sizes,
+                                            &dest_data,&dest_sizes);
+    FCLAW_FREE(pv.data);
+    FCLAW_FREE(pv.sizes);
+    FCLAW_FREE(pv.offsets);
+
+    fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_PARTITION_COMM]);
+    fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_PARTITION]);
+    if (running != FCLAW2D_TIMER_NONE)
+    {
+        fclaw2d_timer_start (&glob->timers[running]);
+    }
+    fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_PARTITION_BUILD]);
+
+    pv.sizes = dest_sizes;
+    pv.data = (char*) dest_data;
+    partition_variable_offsets(&pv,domain_partitioned->local_num_patches);
+#if defined(_OPENMP)
+    fclaw2d_global_iterate_partitioned_mthread(glob,domain_partitioned,
+                                               cb_partition_transfer_variable,
+                                               (void*) &pv);
+#else
+    fclaw2d_global_iterate_partitioned(glob,domain_partitioned,
+                                       cb_partition_transfer_variable,
+                                       (void*) &pv);
+#endif
+
+    FCLAW_FREE(dest_data);
+    FCLAW_FREE(dest_sizes);
+    FCLAW_FREE(pv.offsets);
+}
+
+typedef struct partition_cost
+{
+    int minlevel;
+    int subcycle;
+    double *level_cost;   /* [0..maxlevel] cost per update, [maxlevel+1..] counts */
+    int num_levels;
+    double local_cost;
+} partition_cost_t;
+
+static
+void cb_partition_cost(fclaw2d_domain_t *domain,
+                       fclaw2d_patch_t *patch,
+                       int blockno,
+                       int patchno,
+                       void *user)
+{
+    fclaw2d_global_iterate_t *g = (fclaw2d_global_iterate_t *) user;
+    partition_cost_t *pc = (partition_cost_t*) g->user;
+
+    double cost = fclaw2d_patch_get_cost(g->glob,patch);
+    if (cost <= 0)
+    {
+        return;
+    }
+
+    /* Older measurements count as a single update from now on, so the
+       cost follows the solution as it changes */
+    fclaw2d_patch_set_cost(g->glob,patch,cost);
+
+    int level = patch->level;
+    pc->level_cost[level] += cost;
+    pc->level_cost[pc->num_levels + level] += 1;
+
+    /* With subcycling, finer patches are updated more often per coarse step */
+    int steps = pc->subcycle ? 1 << (level - pc->minlevel) : 1;
+    pc->local_cost += steps*cost;
+}
+
+/* Weight of a patch whose cost per coarse step is the global mean */
+#define PARTITION_WEIGHT_UNIT 1024
+#define PARTITION_WEIGHT_MAX  (1 << 24)
+
+typedef struct partition_weight
+{
+    fclaw2d_global_t *glob;
+    int minlevel;
+    int subcycle;
+    double *level_cost;   /* Mean cost per update on each level */
+    double unit;          /* Cost per coarse step of weight one */
+} partition_weight_t;
+
+/* Patch cost per coarse step, scaled to an integer partition weight.
+   Patches not yet updated are given the mean cost of their level. */
+static
+int cb_partition_weight(fclaw2d_domain_t *domain,
+                        fclaw2d_patch_t *patch,
+                        int blockno,
+                        int patchno,
+                        void *user)
+{
+    partition_weight_t *pw = (partition_weight_t*) user;
+    double cost = fclaw2d_patch_get_cost(pw->glob,patch);
+    int level = patch->level;
+    if (cost <= 0)
+    {
+        cost = pw->level_cost[level];
+    }
+    int steps = pw->subcycle ? 1 << (level - pw->minlevel) : 1;
+    double weight = steps*cost/pw->unit + 0.5;
+    if (weight < 1)
+    {
+        return 1;
+    }
+    return weight > PARTITION_WEIGHT_MAX ? PARTITION_WEIGHT_MAX : (int) weight;
+}
+
+/* Gather the measured costs and set up the partition weights.  Returns 0
+   if no patch has a cost yet, in which case the level weights are used. */
+static
+int partition_cost_weights(fclaw2d_global_t* glob, partition_weight_t *pw)
+{
+    fclaw2d_domain_t *domain = glob->domain;
+    const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+    int mpiret;
+
+    partition_cost_t pc;
+    pc.minlevel = domain->global_minlevel;
+    pc.subcycle = fclaw_opt->subcycle;
+    pc.num_levels = domain->global_maxlevel + 1;
+    pc.level_cost = FCLAW_ALLOC_ZERO(double,2*pc.num_levels + 1);
+    pc.local_cost = 0;
+
+    fclaw2d_global_iterate_patches(glob,cb_partition_cost,&pc);
+
+    /* Sum per level costs and counts and find the most loaded rank */
+    double *global_cost = FCLAW_ALLOC(double,2*pc.num_levels + 1);
+    pc.level_cost[2*pc.num_levels] = pc.local_cost;
+    mpiret = sc_MPI_Allreduce(pc.level_cost, global_cost, 2*pc.num_levels + 1,
+                              sc_MPI_DOUBLE, sc_MPI_SUM, domain->mpicomm);
+    SC_CHECK_MPI(mpiret);
+    double max_cost;
+    mpiret = sc_MPI_Allreduce(&pc.local_cost, &max_cost, 1,
+                              sc_MPI_DOUBLE, sc_MPI_MAX, domain->mpicomm);
+    SC_CHECK_MPI(mpiret);
+    FCLAW_FREE(pc.level_cost);
+
+    glob->count_patch_cost = pc.local_cost;
+    double total_cost = global_cost[2*pc.num_levels];
+    if (total_cost <= 0)
+    {
+        FCLAW_FREE(global_cost);
+        return 0;
+    }
+    fclaw_global_infof("Partition : patch cost imbalance (max/mean) %8.3f\n",
+                       max_cost*domain->mpisize/total_cost);
+
+    /* Mean cost per update of each level; levels without measured patches
+       take the mean over all levels */
+    double update_cost = 0, count = 0;
+    for (int level = pc.minlevel; level < pc.num_levels; level++)
+    {
+        update_cost += global_cost[level];
+        count += global_cost[pc.num_levels + level];
+    }
+    pw->glob = glob;
+    pw->minlevel = pc.minlevel;
+    pw->subcycle = pc.subcycle;
+    pw->level_cost = FCLAW_ALLOC(double,pc.num_levels);
+    for (int level = 0; level < pc.num_levels; level++)
+    {
+        double n = global_cost[pc.num_levels + level];
+        pw->level_cost[level] = n > 0 ? global_cost[level]/n : update_cost/count;
+    }
+    pw->unit = total_cost/count/PARTITION_WEIGHT_UNIT;
+
+    FCLAW_FREE(global_cost);
+    return 1;
+}
+
 /* --------------------------------------------------------------------------
    Public interface
    -------------------------------------------------------------------------- */
+int fclaw2d_partition_needed(fclaw2d_global_t* glob)
+{
+    const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+    fclaw2d_domain_t *domain = glob->domain;
+    int mpiret;
+
+    if (fclaw_opt->partition_imbalance <= 0 || domain->mpisize == 1)
+    {
+        return 1;
+    }
+    if (fclaw_opt->partition_max_skip > 0 &&
+        glob->partition_skipped >= fclaw_opt->partition_max_skip)
+    {
+        return 1;
+    }
+
+    /* Weighted patch counts, as the partition weighs them */
+    double weight[2];
+    int exponent = fclaw_opt->subcycle && fclaw_opt->weighted_partition ? 1 : 0;
+    partition_weight_t pw;
+    if (fclaw_opt->partition_cost && partition_cost_weights(glob, &pw))
+    {
+        weight[0] = 0;
+        for (int blockno = 0; blockno < domain->num_blocks; blockno++)
+        {
+            fclaw2d_block_t *block = &domain->blocks[blockno];
+            for (int patchno = 0; patchno < block->num_patches; patchno++)
+            {
+                weight[0] += cb_partition_weight(domain,
+                                                 &block->patches[patchno],
+                                                 blockno, patchno, &pw);
+            }
+        }
+        FCLAW_FREE(pw.level_cost);
+        mpiret = sc_MPI_Allreduce(&weight[0], &weight[1], 1, sc_MPI_DOUBLE,
+                                  sc_MPI_SUM, domain->mpicomm);
+        SC_CHECK_MPI(mpiret);
+    }
+    else if (exponent == 0)
+    {
+        weight[0] = domain->local_num_patches;
+        weight[1] = domain->global_num_patches;
+    }
+    else
+    {
+        weight[0] = 0;
+        for (int blockno = 0; blockno < domain->num_blocks; blockno++)
+        {
+            fclaw2d_block_t *block = &domain->blocks[blockno];
+            for (int patchno = 0; patchno < block->num_patches; patchno++)
+            {
+                int level = block->patches[patchno].level;
+                weight[0] += 1 << (level - domain->global_minlevel);
+            }
+        }
+        mpiret = sc_MPI_Allreduce(&weight[0], &weight[1], 1, sc_MPI_DOUBLE,
+                                  sc_MPI_SUM, domain->mpicomm);
+        SC_CHECK_MPI(mpiret);
+    }
+
+    double max_weight;
+    mpiret = sc_MPI_Allreduce(&weight[0], &max_weight, 1, sc_MPI_DOUBLE,
+                              sc_MPI_MAX, domain->mpicomm);
+    SC_CHECK_MPI(mpiret);
+
+    double imbalance = max_weight*domain->mpisize/weight[1] - 1;
+    if (imbalance > fclaw_opt->partition_imbalance)
+    {
+        return 1;
+    }
+
+    fclaw_global_infof("Skipping partition : imbalance %6.3f is below %6.3f\n",
+                       imbalance, fclaw_opt->partition_imbalance);
+    ++glob->partition_skipped;
+    return 0;
+}
+
 /* Question : Do all patches on this processor get packed? */
 void fclaw2d_partition_domain(fclaw2d_global_t* glob,
                               fclaw2d_timer_names_t running)
 {
     fclaw2d_domain_t** domain = &glob->domain;
     fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_PARTITION]);
+    glob->partition_skipped = 0;
 
     /* will need to access the subcyle switch */
     const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
 
-    /* allocate memory for parallel transfor of patches
-       use data size (in bytes per patch) below. */
-    fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_PARTITION_BUILD]);
-    size_t psize = fclaw2d_patch_partition_packsize(glob);
-    size_t data_size = psize;  /* Includes sizeof(data_type) */
+    /* Level weights used by the partition, unless patch costs are known.
+       Patch costs are rescaled here, before they are packed and sent along
+       with the patches. */
+    int exponent = fclaw_opt->subcycle && fclaw_opt->weighted_partition ? 1 : 0;
+    partition_weight_t pw;
+    int use_cost = fclaw_opt->partition_cost && partition_cost_weights(glob, &pw);
+
+    /* With refine-on-destination or compression, patches are packed after
+       the partition is known and sent with varying sizes */
+    int variable = fclaw_opt->refine_on_destination ||
+                   fclaw_opt->partition_compress;
+    int64_t *old_offsets = NULL;
     void ** patch_data = NULL;
 
-    fclaw2d_domain_allocate_before_partition (*domain, data_size,
-                                              &patch_data);
-
-    /* For all (patch i) { pack its numerical data into patch_data[i] }
-       Does all the data in every patch need to be copied?  */
-    fclaw2d_global_iterate_patches(glob,
-                                   cb_partition_pack,
-                                   (void *) patch_data);
+    fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_PARTITION_BUILD]);
+    if (variable)
+    {
+        old_offsets = fclaw2d_domain_save_partition(*domain);
+    }
+    else
+    {
+        /* allocate memory for parallel transfor of patches
+           use data size (in bytes per patch) below. */
+        size_t psize = fclaw2d_patch_partition_packsize(glob);
+        size_t data_size = psize;  /* Includes sizeof(data_type) */
+
+        fclaw2d_domain_allocate_before_partition (*domain, data_size,
+                                                  &patch_data);
+
+        /* For all (patch i) { pack its numerical data into patch_data[i] }
+           Does all the data in every patch need to be copied?  */
+#if defined(_OPENMP)
+        /* Each patch is packed into its own slot of patch_data */
+        fclaw2d_global_iterate_patches_mthread(glob,
+                                               cb_partition_pack,
+                                               (void *) patch_data);
+#else
+        fclaw2d_global_iterate_patches(glob,
+                                       cb_partition_pack,
+                                       (void *) patch_data);
+#endif
+    }
     fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_PARTITION_BUILD]);
 
 
     /* this call creates a new domain that is valid after partitioning
        and transfers the data packed above to the new owner processors */
-    int exponent = fclaw_opt->subcycle && fclaw_opt->weighted_partition ? 1 : 0;
     fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_PARTITION]);
     if (running != FCLAW2D_TIMER_NONE)
     {
         fclaw2d_timer_stop (&glob->timers[running]);
     }
     fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_PARTITION_COMM]);
-    fclaw2d_domain_t *domain_partitioned =
+    fclaw2d_domain_t *domain_partitioned = use_cost ?
+        fclaw2d_domain_partition_weighted (*domain, cb_partition_weight, &pw) :
         fclaw2d_domain_partition (*domain, exponent);
+    if (use_cost)
+    {
+        FCLAW_FREE(pw.level_cost);
+    }
     int have_new_partition = domain_partitioned != NULL;
 
     if (have_new_partition)
@@ -168,13 +882,39 @@ void fclaw2d_partition_domain(fclaw2d_global_t* glob,
     {
         fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_PARTITION_BUILD]);
 
-        /* update patch array to point to the numerical data that was received */
-        fclaw2d_domain_retrieve_after_partition (domain_partitioned,&patch_data);
-
-        /* New version? */
-        fclaw2d_global_iterate_partitioned(glob,domain_partitioned,
-                                           cb_partition_transfer,
-                                           (void*) patch_data);
+        if (variable)
+        {
+            partition_transfer_variable(glob,domain_partitioned,
+                                        old_offsets,running);
+        }
+        else
+        {
+            /* update patch array to point to the numerical data that was received */
+            fclaw2d_domain_retrieve_after_partition (domain_partitioned,&patch_data);
+
+            /* Received patches may adopt this memory as their storage instead
+               of copying out of it; it is freed once the last one lets go. */
+            fclaw2d_domain_data_t *ddata_new = 
+                fclaw2d_domain_get_data(domain_partitioned);
+            ddata_new->partition_kept = 
+                fclaw2d_domain_keep_after_partition(domain_partitioned);
+
+            /* New version? */
+#if defined(_OPENMP)
+            /* Patches are unpacked from their own slots; patch build counts
+               and references to the kept partition data are thread safe */
+            fclaw2d_global_iterate_partitioned_mthread(glob,domain_partitioned,
+                                                       cb_partition_transfer,
+                                                       (void*) patch_data);
+#else
+            fclaw2d_global_iterate_partitioned(glob,domain_partitioned,
+                                               cb_partition_transfer,
+                                               (void*) patch_data);
+#endif
+
+            fclaw2d_domain_kept_unref(ddata_new->partition_kept);
+            ddata_new->partition_kept = NULL;
+        }
 
         /* then the old domain is no longer necessary */
         fclaw2d_domain_reset(glob);
@@ -187,7 +927,14 @@ void fclaw2d_partition_domain(fclaw2d_global_t* glob,
     }
 
     /* free the data that was used in the parallel transfer of patches */
-    fclaw2d_domain_free_after_partition (*domain, &patch_data);
+    if (variable)
+    {
+        FCLAW_FREE(old_offsets);
+    }
+    else
+    {
+        fclaw2d_domain_free_after_partition (*domain, &patch_data);
+    }
 
     fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_PARTITION]);
 }
@@ -41,6 +41,22 @@ struct fclaw2d_domain;
 void fclaw2d_partition_domain(struct fclaw2d_global* glob, 
                               fclaw2d_timer_names_t running);
 
+/**
+ * @brief Decide if a new mesh should be repartitioned
+ *
+ * With the option partition-imbalance, the weighted patch count of the
+ * most loaded rank is compared to the mean, using the same weights as the
+ * partition: measured patch costs with partition-cost, level weights
+ * otherwise.  Repartitioning is skipped while the imbalance stays below
+ * the threshold, but not more than partition-max-skip times in a row.
+ * If skipped, the adapt must be finished with fclaw2d_domain_keep_partition.
+ * Collective over the domain.
+ *
+ * @param[in,out] glob the global context
+ * @return true if the domain should be repartitioned
+ */
+int fclaw2d_partition_needed(struct fclaw2d_global* glob);
+
 #ifdef __cplusplus
 #if 0
 {
@@ -30,11 +30,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <fclaw2d_global.h>
 #include <fclaw2d_domain.h>
 #include <fclaw2d_defs.h>
+#include <fclaw2d_options.h>
 #else
 #include <fclaw3d_patch.h>
 #include <fclaw3d_global.h>
 #include <fclaw3d_domain.h>
 #include <fclaw3d_defs.h>
+#include <fclaw3d_options.h>
 #endif
 
 struct fclaw2d_patch_transform_data;
@@ -84,12 +86,17 @@ void patch_data_new(fclaw2d_global_t* glob,
 
 	pdata->patch_idx = this_patch_idx;
 	pdata->block_idx = this_block_idx;
+	pdata->cost = 0;
+	pdata->cost_updates = 0;
+	pdata->refine_parent = NULL;
+	pdata->refine_deferred = 0;
 
 	/* create new user data */
 	FCLAW_ASSERT(patch_vt->patch_new != NULL);
 	pdata->user_patch = patch_vt->patch_new();
 
 	fclaw2d_domain_data_t *ddata = fclaw2d_domain_get_data(glob->domain);
+#pragma omp atomic
 	++ddata->count_set_patch; //this is now in cb_fclaw2d_regrid_repopulate 
 	pdata->neighbors_set = 0;
 }
@@ -130,6 +137,7 @@ void fclaw2d_patch_data_delete(fclaw2d_global_t *glob,
 
         fclaw2d_domain_data_t *ddata = fclaw2d_domain_get_data(glob->domain);        
         patch_vt->patch_delete(pdata->user_patch);
+#pragma omp atomic
         ++ddata->count_delete_patch;
 
 		FCLAW_FREE(pdata);
@@ -289,8 +297,13 @@ double fclaw2d_patch_single_step_update(fclaw2d_global_t *glob,
 	fclaw2d_patch_vtable_t *patch_vt = fclaw2d_patch_vt(glob);
 	FCLAW_ASSERT(patch_vt->single_step_update != NULL);
 
+	if (patch_vt->begin_update != NULL)
+	{
+		patch_vt->begin_update(glob,this_patch);
+	}
     double maxcfl = patch_vt->single_step_update(glob,this_patch,this_block_idx,
                                                    this_patch_idx,t,dt, user);
+    get_patch_data(this_patch)->cost_updates += 1;
     return maxcfl;
 }
 
@@ -569,6 +582,101 @@ void fclaw2d_patch_interpolate2fine(fclaw2d_global_t* glob,
 							   fine0_patchno);
 }
 
+void fclaw2d_patch_defer_interpolate2fine(fclaw2d_global_t* glob,
+										  fclaw2d_patch_t* coarse_patch,
+										  fclaw2d_patch_t* fine_patches)
+{
+	FCLAW_ASSERT(fclaw2d_patch_is_first_sibling(&fine_patches[0]));
+	for (int i = 1; i < FCLAW2D_NUMSIBLINGS; i++)
+	{
+		FCLAW_ASSERT(fine_patches[i].level == coarse_patch->level + 1);
+	}
+
+	fclaw2d_patch_t *parent = FCLAW_ALLOC(fclaw2d_patch_t,1);
+	*parent = *coarse_patch;
+	coarse_patch->user = NULL;
+
+	fclaw2d_patch_set_deferred_parent(glob,parent,&fine_patches[0]);
+	for (int i = 1; i < FCLAW2D_NUMSIBLINGS; i++)
+	{
+		get_patch_data(&fine_patches[i])->refine_deferred = 1;
+	}
+}
+
+void fclaw2d_patch_set_deferred_parent(fclaw2d_global_t* glob,
+									   fclaw2d_patch_t* coarse_patch,
+									   fclaw2d_patch_t* fine_patch)
+{
+	fclaw2d_patch_data_t *pdata = get_patch_data(fine_patch);
+	FCLAW_ASSERT(pdata->refine_parent == NULL);
+	pdata->refine_parent = coarse_patch;
+	pdata->refine_deferred = 1;
+}
+
+fclaw2d_patch_t* fclaw2d_patch_get_deferred_parent(fclaw2d_global_t* glob,
+												   fclaw2d_patch_t* fine_patch)
+{
+	return get_patch_data(fine_patch)->refine_parent;
+}
+
+fclaw2d_patch_t* fclaw2d_patch_take_deferred_parent(fclaw2d_global_t* glob,
+													fclaw2d_patch_t* fine_patch)
+{
+	fclaw2d_patch_data_t *pdata = get_patch_data(fine_patch);
+	fclaw2d_patch_t *parent = pdata->refine_parent;
+	pdata->refine_parent = NULL;
+	return parent;
+}
+
+int fclaw2d_patch_is_deferred(fclaw2d_global_t* glob,
+							  fclaw2d_patch_t* fine_patch)
+{
+	return get_patch_data(fine_patch)->refine_deferred;
+}
+
+void fclaw2d_patch_interpolate2fine_deferred(fclaw2d_global_t* glob,
+											 fclaw2d_patch_t* fine_patches,
+											 int blockno,
+											 int fine0_patchno)
+{
+	fclaw2d_patch_t *parent = 
+	        fclaw2d_patch_take_deferred_parent(glob,&fine_patches[0]);
+	FCLAW_ASSERT(parent != NULL);
+
+	/* The partition keeps families on one process (partition for
+	   coarsening), so the siblings follow the first one in its block */
+	FCLAW_ASSERT(fclaw2d_patch_is_first_sibling(&fine_patches[0]));
+	FCLAW_ASSERT(fine_patches == 
+	             &glob->domain->blocks[blockno].patches[fine0_patchno]);
+	FCLAW_ASSERT(fine0_patchno + FCLAW2D_NUMSIBLINGS <= 
+	             glob->domain->blocks[blockno].num_patches);
+	for (int i = 1; i < FCLAW2D_NUMSIBLINGS; i++)
+	{
+		FCLAW_ASSERT(fine_patches[i].level == fine_patches[0].level);
+		FCLAW_ASSERT(get_patch_data(&fine_patches[i])->refine_deferred);
+	}
+
+	/* The coarse patch number is that of the first fine patch, since the
+	   coarse patch is no longer in the domain */
+	fclaw2d_patch_interpolate2fine(glob,parent,fine_patches,
+								   blockno,fine0_patchno,fine0_patchno);
+
+	/* Fine patches sent without data start with the coarse patch cost */
+	double cost = fclaw2d_patch_get_cost(glob,parent);
+	for (int i = 0; i < FCLAW2D_NUMSIBLINGS; i++)
+	{
+		fclaw2d_patch_data_t *pdata = get_patch_data(&fine_patches[i]);
+		pdata->refine_deferred = 0;
+		if (pdata->cost_updates == 0)
+		{
+			fclaw2d_patch_set_cost(glob,&fine_patches[i],cost);
+		}
+	}
+
+	fclaw2d_patch_data_delete(glob,parent);
+	FCLAW_FREE(parent);
+}
+
 /* ---------------------------- Ghost patches (local and remote) ---------------------- */
 
 size_t fclaw2d_patch_ghost_packsize(fclaw2d_global_t* glob)
@@ -661,6 +769,7 @@ void fclaw2d_patch_remote_ghost_delete(fclaw2d_global_t *glob,
 		this_patch->user = NULL;
 
 		fclaw2d_domain_data_t *ddata = fclaw2d_domain_get_data(glob->domain);
+#pragma omp atomic
 		++ddata->count_delete_patch;
 	}
 }
@@ -685,6 +794,49 @@ size_t fclaw2d_patch_partition_packsize(fclaw2d_global_t* glob)
 	fclaw2d_patch_vtable_t *patch_vt = fclaw2d_patch_vt(glob);
 	FCLAW_ASSERT(patch_vt->partition_packsize != NULL);
 
+	const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+	size_t cost_size = fclaw_opt->partition_cost ? 2*sizeof(double) : 0;
+	return patch_vt->partition_packsize(glob) + cost_size;
+}
+
+void fclaw2d_patch_pack_levels(fclaw2d_global_t* glob)
+{
+	fclaw2d_patch_vtable_t *patch_vt = fclaw2d_patch_vt(glob);
+	if (patch_vt->pack_levels != NULL)
+	{
+		patch_vt->pack_levels(glob);
+	}
+}
+
+void fclaw2d_patch_memory_report(fclaw2d_global_t* glob)
+{
+	fclaw2d_patch_vtable_t *patch_vt = fclaw2d_patch_vt(glob);
+	if (patch_vt->memory_report != NULL)
+	{
+		patch_vt->memory_report(glob);
+	}
+}
+
+void fclaw2d_patch_release_memory(fclaw2d_global_t* glob)
+{
+	fclaw2d_patch_vtable_t *patch_vt = fclaw2d_patch_vt(glob);
+	if (patch_vt->release_memory != NULL)
+	{
+		patch_vt->release_memory(glob);
+	}
+}
+
+/* With partition-cost, the average cost and update count of a patch follow
+   its packed data, so the cost survives the partition that it weighs. */
+static
+size_t patch_partition_cost_offset(fclaw2d_global_t* glob)
+{
+	const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+	if (!fclaw_opt->partition_cost)
+	{
+		return 0;
+	}
+	fclaw2d_patch_vtable_t *patch_vt = fclaw2d_patch_vt(glob);
 	return patch_vt->partition_packsize(glob);
 }
 
@@ -702,6 +854,15 @@ void fclaw2d_patch_partition_pack(fclaw2d_global_t *glob,
 							 this_block_idx,
 							 this_patch_idx,
 							 pack_data_here);
+
+	size_t offset = patch_partition_cost_offset(glob);
+	if (offset > 0)
+	{
+		double cost[2];
+		cost[0] = fclaw2d_patch_get_cost(glob,this_patch);
+		cost[1] = get_patch_data(this_patch)->cost_updates;
+		memcpy((char*) pack_data_here + offset,cost,sizeof(cost));
+	}
 }
 
 
@@ -728,6 +889,41 @@ void fclaw2d_patch_partition_unpack(fclaw2d_global_t *glob,
 							   this_block_idx,
 							   this_patch_idx,
 							   unpack_data_from_here);
+
+	size_t offset = patch_partition_cost_offset(glob);
+	if (offset > 0)
+	{
+		double cost[2];
+		memcpy(cost,(char*) unpack_data_from_here + offset,sizeof(cost));
+		fclaw2d_patch_data_t *pdata = get_patch_data(this_patch);
+		pdata->cost = cost[0]*cost[1];
+		pdata->cost_updates = cost[1];
+	}
+}
+
+/* ----------------------------------- Cost model ------------------------------------- */
+
+void fclaw2d_patch_add_cost(fclaw2d_global_t* glob,
+							fclaw2d_patch_t* patch,
+							double cost)
+{
+	get_patch_data(patch)->cost += cost;
+}
+
+double fclaw2d_patch_get_cost(fclaw2d_global_t* glob,
+							  fclaw2d_patch_t* patch)
+{
+	fclaw2d_patch_data_t *pdata = get_patch_data(patch);
+	return pdata->cost_updates > 0 ? pdata->cost/pdata->cost_updates : pdata->cost;
+}
+
+void fclaw2d_patch_set_cost(fclaw2d_global_t* glob,
+							fclaw2d_patch_t* patch,
+							double cost)
+{
+	fclaw2d_patch_data_t *pdata = get_patch_data(patch);
+	pdata->cost = cost;
+	pdata->cost_updates = cost > 0 ? 1 : 0;
 }
 
 /* ----------------------------- Conservative updates --------------------------------- */
@@ -105,7 +105,14 @@ void fclaw2d_physical_set_bc(fclaw2d_global_t *glob,
     fclaw2d_physical_time_info_t t_info;
     t_info.level_time = sync_time;
     t_info.time_interp = time_interp;
+#if defined(_OPENMP)
+    /* Each patch only sets its own ghost cells */
+    fclaw2d_global_iterate_level_mthread(glob, level,
+                                         cb_fclaw2d_physical_set_bc,
+                                         (void *) &t_info);
+#else
     fclaw2d_global_iterate_level(glob, level,
                                  cb_fclaw2d_physical_set_bc,
                                  (void *) &t_info);
+#endif
 }
@@ -80,6 +80,62 @@ void save_time_step(fclaw2d_global_t *glob)
     fclaw2d_global_iterate_patches(glob,cb_save_time_step,(void *) NULL);
 }
 
+/* -------------------------------------------------------------------------------
+   Speculative cfl control ('speculative-cfl')
+   The global maximum of the cfl of one step is reduced non-blocking while the
+   next step is taken.  Only one time step is saved, so steps are taken in pairs :
+   the first step of a pair is accepted tentatively, and if either step exceeds
+   the maximum cfl, both are retaken from the saved time step.
+   -------------------------------------------------------------------------------- */
+typedef struct cfl_lag
+{
+    int pending;                /* First step of a pair taken tentatively */
+    fclaw2d_domain_reduce_t reduce;
+    double t_start;             /* Time at the start of the pair */
+    int n_start;                /* Step counter at the start of the pair */
+} cfl_lag_t;
+
+static
+void cfl_lag_begin(fclaw2d_global_t *glob, cfl_lag_t *lag,
+                   double maxcfl_step, double t_start, int n_start)
+{
+    fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_CFL_COMM]);
+    fclaw2d_domain_global_maximum_begin(glob->domain, maxcfl_step, &lag->reduce);
+    fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_CFL_COMM]);
+
+    lag->pending = 1;
+    lag->t_start = t_start;
+    lag->n_start = n_start;
+}
+
+/* Returns the maximum cfl over both steps of the pair */
+static
+double cfl_lag_end(fclaw2d_global_t *glob, cfl_lag_t *lag, double maxcfl_step)
+{
+    FCLAW_ASSERT(lag->pending);
+
+    fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_CFL_COMM]);
+    double maxcfl_first = fclaw2d_domain_global_maximum_end(glob->domain,
+                                                            &lag->reduce);
+    maxcfl_step = fclaw2d_domain_global_maximum(glob->domain, maxcfl_step);
+    fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_CFL_COMM]);
+
+    lag->pending = 0;
+    fclaw_global_infof("   maxcfl (previous step) = %16.8f\n",maxcfl_first);
+
+    return fmax(maxcfl_first,maxcfl_step);
+}
+
+/* Let solvers tag patches for refinement while updating them, if the step
+   ending at t_end is followed by a regrid */
+static
+void set_tag_in_update(fclaw2d_global_t *glob, int regrid_next, double t_end)
+{
+    const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+    glob->tag_in_update = fclaw_opt->tag_in_update && regrid_next;
+    glob->tag_in_update_time = t_end;
+}
+
 
 /* -------------------------------------------------------------------------------
    Output style 1
@@ -143,6 +199,11 @@ void outstyle_1(fclaw2d_global_t *glob)
     double t_curr = t0;
     int n_inner = 0;
 
+    int speculative = fclaw_opt->reduce_cfl && fclaw_opt->speculative_cfl &&
+                      !fclaw_opt->use_fixed_dt && !fclaw_opt->advance_one_step;
+    cfl_lag_t lag;
+    lag.pending = 0;
+
     int n;
     for(n = 0; n < nout; n++)
     {
@@ -152,8 +213,8 @@ void outstyle_1(fclaw2d_global_t *glob)
         double tend = tstart + dt_outer;
         while (t_curr < tend)
         {
-            /* In case we have to reject this step */
-            if (!fclaw_opt->use_fixed_dt)
+            /* In case we have to reject this step (or pair of steps) */
+            if (!fclaw_opt->use_fixed_dt && !lag.pending)
             {
                 save_time_step(glob);
             }
@@ -196,9 +257,37 @@ void outstyle_1(fclaw2d_global_t *glob)
                 }
             }
             glob->curr_dt = dt_step;  
+            int regrid_next = fclaw_opt->regrid_interval > 0 &&
+                              (n_inner + 1) % fclaw_opt->regrid_interval == 0;
+            set_tag_in_update(glob, regrid_next, t_curr + dt_step);
             double maxcfl_step = fclaw2d_advance_all_levels(glob, t_curr,dt_step);
 
-            if (fclaw_opt->reduce_cfl)
+            /* Accept this step tentatively if the next step will use the same
+               dt and is taken on the same grid. */
+            if (speculative && !lag.pending && !took_small_step &&
+                !took_big_step && tend - (t_curr + 2*dt_step) >= tol &&
+                !regrid_next)
+            {
+                cfl_lag_begin(glob, &lag, maxcfl_step, t_curr, n_inner);
+                fclaw_global_productionf("Level %d (%d-%d) step %5d : dt = %12.3e; maxcfl (local) = " \
+                                         "%16.8f; Final time = %12.4f\n",
+                                         fclaw_opt->minlevel,
+                                         (*domain)->global_minlevel,
+                                         (*domain)->global_maxlevel,
+                                         n_inner+1,dt_step,
+                                         maxcfl_step, t_curr + dt_step);
+                n_inner++;
+                t_curr += dt_step;
+                glob->curr_time = t_curr;
+                continue;
+            }
+
+            int retake_pair = lag.pending;
+            if (lag.pending)
+            {
+                maxcfl_step = cfl_lag_end(glob, &lag, maxcfl_step);
+            }
+            else if (fclaw_opt->reduce_cfl)
             {
                 /* If we are taking a variable time step, we have to reduce the 
                    maxcfl so that every processor takes the same size dt */
@@ -225,6 +314,13 @@ void outstyle_1(fclaw2d_global_t *glob)
                 if (!fclaw_opt->use_fixed_dt)
                 {
                     restore_time_step(glob);
+                    if (retake_pair)
+                    {
+                        /* Also retake the tentatively accepted step */
+                        t_curr = lag.t_start;
+                        n_inner = lag.n_start;
+                        glob->curr_time = t_curr;
+                    }
 
                     /* Modify dt_level0 from step used. */
                     dt_minlevel = dt_minlevel*fclaw_opt->desired_cfl/maxcfl_step;
@@ -347,6 +443,11 @@ void outstyle_3(fclaw2d_global_t *glob)
         }
     }
 
+    int speculative = fclaw_opt->reduce_cfl && fclaw_opt->speculative_cfl &&
+                      !fclaw_opt->use_fixed_dt;
+    cfl_lag_t lag;
+    lag.pending = 0;
+
     int n = 0;
     double t_curr = t0;
     while (n < nstep_outer)
@@ -360,19 +461,49 @@ void outstyle_3(fclaw2d_global_t *glob)
             dt_step /= level_factor;
         }
 
-        /* In case we have to reject this step */
-        if (!fclaw_opt->use_fixed_dt)
+        /* In case we have to reject this step (or pair of steps) */
+        if (!fclaw_opt->use_fixed_dt && !lag.pending)
         {
             save_time_step(glob);
         }
 
         /* Get current domain data since it may change during regrid */
         glob->curr_dt = dt_step;
+        set_tag_in_update(glob, nregrid_interval > 0 && (n + 1) % nregrid_interval == 0,
+                          t_curr + dt_step);
         double maxcfl_step = fclaw2d_advance_all_levels(glob, t_curr,dt_step);
 
-        /* This is a collective communication - everybody needs to wait here. */
-        if (fclaw_opt->reduce_cfl)
+        int level2print = (fclaw_opt->advance_one_step && fclaw_opt->outstyle_uses_maxlevel) ?
+                          fclaw_opt->maxlevel : fclaw_opt->minlevel;
+
+        /* Accept this step tentatively unless we regrid or write output after
+           it.  The cfl reduction then overlaps with the next step. */
+        int n_next = n + 1;
+        int sync_next = n_next == nstep_outer || n_next % nstep_inner == 0 ||
+                        (nregrid_interval > 0 && n_next % nregrid_interval == 0);
+        if (speculative && !lag.pending && !sync_next)
         {
+            cfl_lag_begin(glob, &lag, maxcfl_step, t_curr, n);
+            fclaw_global_productionf("Level %d (%d-%d) step %5d : dt = %12.3e; maxcfl (local) = " \
+                                     "%16.8f; Final time = %12.4f\n",
+                                     level2print,
+                                     (*domain)->global_minlevel,
+                                     (*domain)->global_maxlevel,
+                                     n+1,dt_step,maxcfl_step, t_curr + dt_step);
+            t_curr += dt_step;
+            glob->curr_time = t_curr;
+            n = n_next;
+            continue;
+        }
+
+        int retake_pair = lag.pending;
+        if (lag.pending)
+        {
+            maxcfl_step = cfl_lag_end(glob, &lag, maxcfl_step);
+        }
+        else if (fclaw_opt->reduce_cfl)
+        {
+            /* This is a collective communication - everybody needs to wait here. */
             /* If we are taking a variable time step, we have to reduce the 
                maxcfl so that every processor takes the same size dt */
             fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_CFL_COMM]);
@@ -381,9 +512,6 @@ void outstyle_3(fclaw2d_global_t *glob)
         }
 
         double tc = t_curr + dt_step;
-        int level2print = (fclaw_opt->advance_one_step && fclaw_opt->outstyle_uses_maxlevel) ?
-                          fclaw_opt->maxlevel : fclaw_opt->minlevel;
-
         fclaw_global_productionf("Level %d (%d-%d) step %5d : dt = %12.3e; maxcfl (step) = " \
                                  "%16.8f; Final time = %12.4f\n",
                                  level2print,
@@ -397,6 +525,13 @@ void outstyle_3(fclaw2d_global_t *glob)
             {
                 fclaw_global_productionf("   WARNING : Maximum CFL exceeded; retaking time step\n");
                 restore_time_step(glob);
+                if (retake_pair)
+                {
+                    /* Also retake the tentatively accepted step */
+                    t_curr = lag.t_start;
+                    n = lag.n_start;
+                    glob->curr_time = t_curr;
+                }
 
                 dt_minlevel = dt_minlevel*fclaw_opt->desired_cfl/maxcfl_step;
 
@@ -471,6 +606,9 @@ void outstyle_4(fclaw2d_global_t *glob)
     while (n < nstep_outer)
     {
         /* Get current domain data since it may change during regrid */
+        set_tag_in_update(glob, fclaw_opt->regrid_interval > 0 &&
+                          (n + 1) % fclaw_opt->regrid_interval == 0,
+                          t_curr + dt_minlevel);
         fclaw2d_advance_all_levels(glob, t_curr, dt_minlevel);
 
         int level2print = (fclaw_opt->advance_one_step && fclaw_opt->outstyle_uses_maxlevel) ?
@@ -27,6 +27,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <fclaw2d_patch.h>
 #include <fclaw2d_global.h>
 
+typedef struct timeinterp_info
+{
+    double alpha;
+    const int *mask;
+    int mask_value;
+} timeinterp_info_t;
+
 static
 void cb_setup_time_interp(fclaw2d_domain_t *domain,
                           fclaw2d_patch_t *this_patch,
@@ -35,10 +42,18 @@ void cb_setup_time_interp(fclaw2d_domain_t *domain,
                           void *user)
 {
     fclaw2d_global_iterate_t *s = (fclaw2d_global_iterate_t*) user;
+    timeinterp_info_t *info = (timeinterp_info_t*) s->user;
+    if (info->mask != NULL)
+    {
+        int patch_num = domain->blocks[blockno].num_patches_before + patchno;
+        if (info->mask[patch_num] != info->mask_value)
+        {
+            return;
+        }
+    }
     if (fclaw2d_patch_has_finegrid_neighbors(this_patch))
     {
-        double alpha = *((double*) s->user);
-        fclaw2d_patch_setup_timeinterp(s->glob,this_patch,alpha);
+        fclaw2d_patch_setup_timeinterp(s->glob,this_patch,info->alpha);
     }
 }
 
@@ -48,10 +63,30 @@ void cb_setup_time_interp(fclaw2d_domain_t *domain,
    via interpolating and averaging) ghost cell values.
    -------------------------------------------------------------------- */
 
-void fclaw2d_timeinterp(fclaw2d_global_t *glob,
-                        int level,double alpha)
+void fclaw2d_timeinterp_subset(fclaw2d_global_t *glob,
+                               int level, double alpha,
+                               fclaw2d_ghost_fill_parallel_mode_t parallel_mode)
 {
+    timeinterp_info_t info;
+    info.alpha = alpha;
+    if (!fclaw2d_ghost_fill_exchange_mask(glob->domain,parallel_mode,
+                                          &info.mask,&info.mask_value))
+    {
+        return;
+    }
+
     /* Store time interpolated data into m_griddata_time_sync. */
+#if defined(_OPENMP)
+    fclaw2d_global_iterate_level_mthread(glob,level,cb_setup_time_interp,
+                                         (void *) &info);
+#else
     fclaw2d_global_iterate_level(glob,level,cb_setup_time_interp,
-                                 (void *) &alpha);
+                                 (void *) &info);
+#endif
+}
+
+void fclaw2d_timeinterp(fclaw2d_global_t *glob,
+                        int level,double alpha)
+{
+    fclaw2d_timeinterp_subset(glob,level,alpha,FCLAW2D_BOUNDARY_ALL);
 }
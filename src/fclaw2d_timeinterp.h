@@ -27,6 +27,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define FCLAW2D_TIMEINTERP_H
 
 #include <fclaw_base.h>    /* Defines FCLAW_F77_FUNC */
+#include <fclaw2d_ghost_fill.h>   /* Needed for parallel mode */
 
 #ifdef __cplusplus
 extern "C"
@@ -41,6 +42,12 @@ struct fclaw2d_global;
 void fclaw2d_timeinterp(struct fclaw2d_global *glob,
                        int level, double alpha);
 
+/* Time interpolate a subset of the patches at a level (see
+   fclaw2d_ghost_fill_exchange_mask) */
+void fclaw2d_timeinterp_subset(struct fclaw2d_global *glob,
+                               int level, double alpha,
+                               fclaw2d_ghost_fill_parallel_mode_t parallel_mode);
+
 #define FCLAW2D_TIMEINTERP_FORT FCLAW_F77_FUNC (fclaw2d_timeinterp_fort, \
                                                 FCLAW2D_TIMEINTERP_FORT)
 void FCLAW2D_TIMEINTERP_FORT(const int *mx, const int* my, const int* mbc,
@@ -60,7 +60,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define fclaw2d_patch_relation_t        fclaw3d_patch_relation_t
 #define fclaw2d_match_callback_t        fclaw3d_match_callback_t
 #define fclaw2d_transfer_callback_t     fclaw3d_transfer_callback_t
+#define fclaw2d_weight_callback_t       fclaw3d_weight_callback_t
 #define fclaw2d_domain_exchange_t       fclaw3d_domain_exchange_t
+#define fclaw2d_domain_kept             fclaw3d_domain_kept
+#define fclaw2d_domain_kept_t           fclaw3d_domain_kept_t
 #define fclaw2d_domain_indirect         fclaw3d_domain_indirect
 #define fclaw2d_domain_indirect_t       fclaw3d_domain_indirect_t
 #define fclaw2d_integrate_ray_t         fclaw3d_integrate_ray_t
@@ -78,6 +81,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define fclaw2d_patch_setup_timeinterp_t fclaw3d_patch_setup_timeinterp_t
 #define fclaw2d_patch_restore_step_t    fclaw3d_patch_restore_step_t
 #define fclaw2d_patch_save_step_t       fclaw3d_patch_save_step_t
+#define fclaw2d_patch_begin_update_t    fclaw3d_patch_begin_update_t
 #define fclaw2d_patch_copy_face_t       fclaw3d_patch_copy_face_t
 #define fclaw2d_patch_average_face_t    fclaw3d_patch_average_face_t
 #define fclaw2d_patch_interpolate_face_t fclaw3d_patch_interpolate_face_t
@@ -100,6 +104,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define fclaw2d_patch_remote_ghost_unpack_t fclaw3d_patch_remote_ghost_unpack_t
 #define fclaw2d_patch_remote_ghost_delete_t fclaw3d_patch_remote_ghost_delete_t
 #define fclaw2d_patch_partition_packsize_t fclaw3d_patch_partition_packsize_t
+#define fclaw2d_patch_pack_levels_t     fclaw3d_patch_pack_levels_t
+#define fclaw2d_patch_memory_report_t   fclaw3d_patch_memory_report_t
+#define fclaw2d_patch_release_memory_t  fclaw3d_patch_release_memory_t
 #define fclaw2d_patch_partition_pack_t  fclaw3d_patch_partition_pack_t
 #define fclaw2d_patch_partition_unpack_t fclaw3d_patch_partition_unpack_t
 #define fclaw2d_patch_time_sync_f2c_t   fclaw3d_patch_time_sync_f2c_t
@@ -157,6 +164,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 /* redefine functions */
 #define fclaw2d_domain_global_maximum   fclaw3d_domain_global_maximum
+#define fclaw2d_domain_reduce_t         fclaw3d_domain_reduce_t
+#define fclaw2d_domain_global_maximum_begin fclaw3d_domain_global_maximum_begin
+#define fclaw2d_domain_global_maximum_end fclaw3d_domain_global_maximum_end
 #define fclaw2d_domain_global_sum       fclaw3d_domain_global_sum
 #define fclaw2d_domain_barrier          fclaw3d_domain_barrier
 #define fclaw2d_domain_dimension        fclaw3d_domain_dimension
@@ -211,6 +221,12 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define fclaw2d_patch_tag4refinement    fclaw3d_patch_tag4refinement
 #define fclaw2d_patch_tag4coarsening    fclaw3d_patch_tag4coarsening
 #define fclaw2d_patch_interpolate2fine  fclaw3d_patch_interpolate2fine
+#define fclaw2d_patch_defer_interpolate2fine fclaw3d_patch_defer_interpolate2fine
+#define fclaw2d_patch_set_deferred_parent fclaw3d_patch_set_deferred_parent
+#define fclaw2d_patch_get_deferred_parent fclaw3d_patch_get_deferred_parent
+#define fclaw2d_patch_take_deferred_parent fclaw3d_patch_take_deferred_parent
+#define fclaw2d_patch_is_deferred       fclaw3d_patch_is_deferred
+#define fclaw2d_patch_interpolate2fine_deferred fclaw3d_patch_interpolate2fine_deferred
 #define fclaw2d_patch_average2coarse    fclaw3d_patch_average2coarse
 #define fclaw2d_patch_ghost_packsize    fclaw3d_patch_ghost_packsize
 #define fclaw2d_patch_local_ghost_alloc fclaw3d_patch_local_ghost_alloc
@@ -222,6 +238,12 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define fclaw2d_patch_partition_pack    fclaw3d_patch_partition_pack
 #define fclaw2d_patch_partition_unpack  fclaw3d_patch_partition_unpack
 #define fclaw2d_patch_partition_packsize fclaw3d_patch_partition_packsize
+#define fclaw2d_patch_pack_levels       fclaw3d_patch_pack_levels
+#define fclaw2d_patch_memory_report     fclaw3d_patch_memory_report
+#define fclaw2d_patch_release_memory    fclaw3d_patch_release_memory
+#define fclaw2d_patch_add_cost          fclaw3d_patch_add_cost
+#define fclaw2d_patch_get_cost          fclaw3d_patch_get_cost
+#define fclaw2d_patch_set_cost          fclaw3d_patch_set_cost
 #define fclaw2d_patch_time_sync_f2c     fclaw3d_patch_time_sync_f2c
 #define fclaw2d_patch_time_sync_samesize fclaw3d_patch_time_sync_samesize
 #define fclaw2d_patch_time_sync_reset   fclaw3d_patch_time_sync_reset
@@ -285,11 +307,18 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define fclaw2d_domain_retrieve_after_partition     fclaw3d_domain_retrieve_after_partition
 #define fclaw2d_domain_iterate_partitioned  fclaw3d_domain_iterate_partitioned
 #define fclaw2d_domain_free_after_partition fclaw3d_domain_free_after_partition
+#define fclaw2d_domain_keep_after_partition fclaw3d_domain_keep_after_partition
+#define fclaw2d_domain_kept_ref         fclaw3d_domain_kept_ref
+#define fclaw2d_domain_kept_unref       fclaw3d_domain_kept_unref
+#define fclaw2d_domain_save_partition   fclaw3d_domain_save_partition
+#define fclaw2d_domain_transfer_after_partition fclaw3d_domain_transfer_after_partition
 #define fclaw2d_domain_allocate_before_exchange fclaw3d_domain_allocate_before_exchange
 #define fclaw2d_domain_free_after_exchange  fclaw3d_domain_free_after_exchange
 #define fclaw2d_domain_ghost_exchange   fclaw3d_domain_ghost_exchange
 #define fclaw2d_domain_ghost_exchange_begin fclaw3d_domain_ghost_exchange_begin
 #define fclaw2d_domain_ghost_exchange_end   fclaw3d_domain_ghost_exchange_end
+#define fclaw2d_domain_ghost_exchange_persistent_setup fclaw3d_domain_ghost_exchange_persistent_setup
+#define fclaw2d_domain_ghost_exchange_persistent_free fclaw3d_domain_ghost_exchange_persistent_free
 #define fclaw2d_domain_free_after_exchange  fclaw3d_domain_free_after_exchange
 
 #define fclaw2d_exchange_setup          fclaw3d_exchange_setup
@@ -303,6 +332,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define fclaw2d_domain_destroy          fclaw3d_domain_destroy
 #define fclaw2d_domain_adapt            fclaw3d_domain_adapt
 #define fclaw2d_domain_partition        fclaw3d_domain_partition
+#define fclaw2d_domain_partition_weighted fclaw3d_domain_partition_weighted
+#define fclaw2d_domain_keep_partition   fclaw3d_domain_keep_partition
 #define fclaw2d_domain_partition_unchanged  fclaw3d_domain_partition_unchanged
 #define fclaw2d_domain_complete         fclaw3d_domain_complete
 #define fclaw2d_domain_write_vtk        fclaw3d_domain_write_vtk
@@ -312,6 +343,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define fclaw2d_domain_search_points    fclaw3d_domain_search_points
 #define fclaw2d_domain_iterate_cb       fclaw3d_domain_iterate_cb
 #define fclaw2d_domain_iterate_level_mthread fclaw3d_domain_iterate_level_mthread
+#define fclaw2d_domain_iterate_patches_mthread fclaw3d_domain_iterate_patches_mthread
+#define fclaw2d_domain_iterate_adapted_mthread fclaw3d_domain_iterate_adapted_mthread
+#define fclaw2d_domain_iterate_partitioned_mthread fclaw3d_domain_iterate_partitioned_mthread
+#define fclaw2d_domain_iterate_level_reduce fclaw3d_domain_iterate_level_reduce
+#define fclaw2d_domain_iterate_level_batched fclaw3d_domain_iterate_level_batched
+#define fclaw2d_patch_batch_callback_t  fclaw3d_patch_batch_callback_t
+#define fclaw2d_patch_reduce_callback_t fclaw3d_patch_reduce_callback_t
+#define fclaw2d_reduce_combine_t        fclaw3d_reduce_combine_t
 #define fclaw_domain_new2d              fclaw_domain_new3d
 #define fclaw_domain_destroy2d          fclaw_domain_destroy3d
 
@@ -341,7 +380,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define fclaw2d_global_iterate_families fclaw3d_global_iterate_families
 #define fclaw2d_global_iterate_adapted  fclaw3d_global_iterate_adapted
 #define fclaw2d_global_iterate_level_mthread fclaw3d_global_iterate_level_mthread
+#define fclaw2d_global_iterate_patches_mthread fclaw3d_global_iterate_patches_mthread
+#define fclaw2d_global_iterate_adapted_mthread fclaw3d_global_iterate_adapted_mthread
+#define fclaw2d_global_iterate_partitioned_mthread fclaw3d_global_iterate_partitioned_mthread
+#define fclaw2d_global_iterate_level_reduce fclaw3d_global_iterate_level_reduce
+#define fclaw2d_global_iterate_level_batched fclaw3d_global_iterate_level_batched
 #define fclaw2d_global_iterate_partitioned fclaw3d_global_iterate_partitioned
+#define fclaw2d_global_scratch          fclaw3d_global_scratch
+#define fclaw2d_global_get_scratch      fclaw3d_global_get_scratch
+#define FCLAW2D_GLOBAL_SCRATCH_SLOTS    FCLAW3D_GLOBAL_SCRATCH_SLOTS
 #define fclaw2d_global_options_store    fclaw3d_global_options_store
 #define fclaw2d_global_get_options      fclaw3d_global_get_options
 #define fclaw2d_global_set_global       fclaw3d_global_set_global
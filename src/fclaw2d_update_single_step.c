@@ -30,15 +30,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <fclaw2d_patch.h>
 
 static
-void cb_single_step_count(fclaw2d_domain_t *domain,
-                          fclaw2d_patch_t *this_patch,
-                          int this_block_idx,
-                          int this_patch_idx,
-                          void *user)
-{    
-    fclaw2d_global_iterate_t* g = (fclaw2d_global_iterate_t*) user;
-    int *count = (int*) g->user;
-    (*count)++;
+void combine_single_step(void *result, const void *local)
+{
+    fclaw2d_single_step_data_t *ss_data = (fclaw2d_single_step_data_t*) result;
+    const fclaw2d_single_step_data_t *ss_local =
+        (const fclaw2d_single_step_data_t*) local;
+
+    ss_data->maxcfl = fmax(ss_data->maxcfl,ss_local->maxcfl);
+    ss_data->count += ss_local->count;
 }
 
 static
@@ -46,58 +45,85 @@ void cb_single_step(fclaw2d_domain_t *domain,
                     fclaw2d_patch_t *this_patch,
                     int this_block_idx,
                     int this_patch_idx,
+                    int batch_iter,
+                    int batch_count,
+                    void *local,
                     void *user)
 {
     fclaw2d_global_iterate_t* g = (fclaw2d_global_iterate_t*) user;
 
     double maxcfl;
     
-    fclaw2d_single_step_data_t *ss_data = (fclaw2d_single_step_data_t *) g->user;
+    /* Private to this thread */
+    fclaw2d_single_step_data_t *ss_data = (fclaw2d_single_step_data_t *) local;
     double dt = ss_data->dt;
     double t = ss_data->t;
+
+    /* Patches in a batch are visited in order by a single thread */
+    ss_data->buffer_data.iter = batch_iter;
+    ss_data->buffer_data.total_count = batch_count;
     
     maxcfl = fclaw2d_patch_single_step_update(g->glob,this_patch,
                                               this_block_idx,
                                               this_patch_idx,t,dt,
                                               &ss_data->buffer_data);
 
-    ss_data->buffer_data.iter++;  /* Used for patch buffer */
-    g->glob->count_single_step++;
-
-    /* Note : In openMP, this reduction is probably not correct */
+    ss_data->count++;
     ss_data->maxcfl = fmax(maxcfl,ss_data->maxcfl);
-
 }
 
 
-double fclaw2d_update_single_step(fclaw2d_global_t *glob,
-                                  int level,
-                                  double t, double dt)
+double fclaw2d_update_single_step_subset(fclaw2d_global_t *glob,
+                                         int level,
+                                         double t, double dt,
+                                         fclaw2d_ghost_fill_parallel_mode_t parallel_mode)
 {
-
-    /* Iterate over every patch at this level */
+    const int *mask;
+    int mask_value;
+    if (!fclaw2d_ghost_fill_exchange_mask(glob->domain,parallel_mode,
+                                          &mask,&mask_value))
+    {
+        return 0;
+    }
+
+    /* Initial values are copied to the data of every thread */
     fclaw2d_single_step_data_t ss_data;
     ss_data.t = t;
     ss_data.dt = dt;
     ss_data.maxcfl = 0;
+    ss_data.count = 0;
     ss_data.buffer_data.total_count = 0;
     ss_data.buffer_data.iter = 0;
+    ss_data.buffer_data.user = NULL;
 
-    /* If there are not grids at this level, we return CFL = 0 */
-#if defined(_OPENMP)        
-    fclaw2d_global_iterate_level_mthread(glob, level, 
-                                         cb_single_step,(void *) &ss_data);
-#else
-    /* Count number of grids to be updated in this call;  not sure how this
-       works in OpenMP.  */
-    int count = 0;
-    fclaw2d_global_iterate_level(glob, level, cb_single_step_count,&count);
-    ss_data.buffer_data.total_count = count;
-
-    fclaw2d_global_iterate_level(glob, level, 
-                                 cb_single_step,(void *) &ss_data);
-#endif   
- 
+    /* Tagging in the update calls Fortran criteria that read the global
+       glob.  It is set once here rather than by each thread. */
+    if (glob->tag_in_update)
+    {
+        fclaw2d_global_set_global(glob);
+    }
+
+    /* If there are not grids at this level, we return CFL = 0.  Without
+       threads, all patches at the level form a single batch. */
+    fclaw2d_global_iterate_level_batched(glob, level, 0, mask, mask_value,
+                                         cb_single_step, NULL,
+                                         &ss_data, sizeof(ss_data),
+                                         combine_single_step);
+
+    if (glob->tag_in_update)
+    {
+        fclaw2d_global_unset_global();
+    }
+
+    glob->count_single_step += ss_data.count;
 
     return ss_data.maxcfl;
 }
+
+double fclaw2d_update_single_step(fclaw2d_global_t *glob,
+                                  int level,
+                                  double t, double dt)
+{
+    return fclaw2d_update_single_step_subset(glob,level,t,dt,
+                                             FCLAW2D_BOUNDARY_ALL);
+}
@@ -30,6 +30,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef AMR_SINGLE_STEP_H
 #define AMR_SINGLE_STEP_H
 
+#include <fclaw2d_ghost_fill.h>   /* Needed for parallel mode */
+
 
 #ifdef __cplusplus
 extern "C"
@@ -43,12 +45,17 @@ struct fclaw2d_global;
 
 /**
  * @brief Buffer data for cudaclaw
+ *
+ * Patches at a level are updated in batches.  The patches of a batch are
+ * passed, in order, to the same thread, so a solver can collect them in
+ * the buffer and update them together when iter == total_count - 1.
+ * Each thread has its own buffer data.
  */
 typedef struct fclaw2d_single_step_buffer_data
 {
-    /** Number of patches in buffer */
+    /** Number of patches in the current batch */
     int total_count;
-    /** Current patch index in buffer */
+    /** Index of the current patch in the batch */
     int iter;
     /**  Buffer pointer */
     void* user;    
@@ -57,6 +64,8 @@ typedef struct fclaw2d_single_step_buffer_data
 
 /**
  * @brief Struct for single step iteration over patches
+ *
+ * One copy is kept per thread;  maxcfl and count are merged at the end.
  */
 typedef struct fclaw2d_single_step_data
 {
@@ -66,6 +75,8 @@ typedef struct fclaw2d_single_step_data
     double dt;
     /** The maxcfl */
     double maxcfl;
+    /** Number of patches updated */
+    int count;
     /** The buffer data */
     fclaw2d_single_step_buffer_data_t buffer_data;
 } fclaw2d_single_step_data_t;
@@ -94,6 +105,24 @@ double fclaw2d_update_single_step(struct fclaw2d_global *glob,
                                   int level,
                                   double t, double dt);
 
+/**
+ * @brief Advance a subset of the patches at a level
+ *
+ * Used to update patches needed for the ghost exchange before the
+ * remaining patches (see fclaw2d_ghost_fill_exchange_mask).
+ *
+ * @param glob the global context
+ * @param level the level to advance
+ * @param t the current time
+ * @param dt the time step
+ * @param parallel_mode which patches to update
+ * @return double the maxcfl
+ */
+double fclaw2d_update_single_step_subset(struct fclaw2d_global *glob,
+                                         int level,
+                                         double t, double dt,
+                                         fclaw2d_ghost_fill_parallel_mode_t parallel_mode);
+
 
 #ifdef __cplusplus
 #if 0
@@ -52,6 +52,16 @@ typedef struct fclaw3d_domain_data
     fclaw3d_domain_exchange_t *domain_exchange;
     fclaw3d_domain_indirect_t *domain_indirect;
 
+    /* Exchange patches and remote ghost patches sorted by level, so that
+       exchanges over a subset of levels only touch those levels.  Level l
+       occupies entries [offset[l], offset[l+1]) of the index arrays. */
+    int exchange_num_levels;
+    int *exchange_level_offset;
+    int *exchange_level_index;  /**< Index into domain_exchange->patch_data */
+    fclaw3d_patch_t **exchange_level_patches;
+    int *ghost_level_offset;
+    int *ghost_level_index;     /**< Index into domain->ghost_patches */
+
 } fclaw3d_domain_data_t;
 
 void fclaw3d_domain_data_new(struct fclaw3d_domain *domain);
@@ -65,10 +75,93 @@ void fclaw3d_domain_reset(struct fclaw3d_global* glob);
 
 fclaw3d_domain_data_t* fclaw3d_domain_get_data(struct fclaw3d_domain *domain);
 
-/* OpenMP iterator (not part of forestclaw3d.h */
+/* OpenMP iterator (not part of forestclaw3d.h).  The patches of the level
+   are collected across all blocks and handed out to threads dynamically. */
 void fclaw3d_domain_iterate_level_mthread (struct fclaw3d_domain * domain, int level,
                                            fclaw3d_patch_callback_t pcb, void *user);
 
+/** Threaded variant of fclaw3d_domain_iterate_patches.  Serial without
+ * OpenMP. */
+void fclaw3d_domain_iterate_patches_mthread (struct fclaw3d_domain * domain,
+                                             fclaw3d_patch_callback_t pcb,
+                                             void *user);
+
+/** Threaded variant of fclaw3d_domain_iterate_adapted.
+ * The old and new patches are matched serially, then the callbacks run
+ * concurrently, so the callback must only touch the patches it is given
+ * and otherwise be thread safe.  Serial without OpenMP.
+ */
+void fclaw3d_domain_iterate_adapted_mthread (struct fclaw3d_domain * old_domain,
+                                             struct fclaw3d_domain * new_domain,
+                                             fclaw3d_match_callback_t mcb,
+                                             void *user);
+
+/** Threaded variant of fclaw3d_domain_iterate_partitioned, with the same
+ * requirements on the callback as fclaw3d_domain_iterate_adapted_mthread.
+ */
+void fclaw3d_domain_iterate_partitioned_mthread (struct fclaw3d_domain * old_domain,
+                                                 struct fclaw3d_domain * new_domain,
+                                                 fclaw3d_transfer_callback_t tcb,
+                                                 void *user);
+
+/** Callback for a level iteration with a thread-local accumulator.
+ * \param [in,out] local   Accumulator private to the calling thread.
+ */
+typedef void (*fclaw3d_patch_reduce_callback_t)
+    (struct fclaw3d_domain * domain, struct fclaw3d_patch * patch,
+     int blockno, int patchno, void *local, void *user);
+
+/** Merge one thread-local accumulator into the final result. */
+typedef void (*fclaw3d_reduce_combine_t) (void *result, const void *local);
+
+/** Iterate over the patches of a level with a reduction.
+ * Uses the same scheduling as fclaw3d_domain_iterate_level_mthread when
+ * OpenMP is enabled and a serial loop otherwise.
+ * \param [in,out] result  On input, the identity of the reduction, which
+ *                         is copied to every thread-local accumulator.
+ *                         On output, the merged result.
+ * \param [in] result_size Size of the accumulator in bytes.
+ * \param [in] combine     Called once per thread, never concurrently.
+ */
+void fclaw3d_domain_iterate_level_reduce (struct fclaw3d_domain * domain,
+                                          int level,
+                                          fclaw3d_patch_reduce_callback_t pcb,
+                                          void *user, void *result,
+                                          size_t result_size,
+                                          fclaw3d_reduce_combine_t combine);
+
+/** Callback for a batched level iteration.
+ * \param [in] batch_iter   Position of this patch within its batch.
+ * \param [in] batch_count  Number of patches in the batch.
+ * \param [in,out] local    Accumulator private to the calling thread.
+ */
+typedef void (*fclaw3d_patch_batch_callback_t)
+    (struct fclaw3d_domain * domain, struct fclaw3d_patch * patch,
+     int blockno, int patchno, int batch_iter, int batch_count,
+     void *local, void *user);
+
+/** Iterate over the patches of a level in batches, with a reduction.
+ * The patches of a batch are consecutive and always visited in order by
+ * one thread, so a callback may buffer patches and process the batch when
+ * batch_iter == batch_count - 1.  Batches are scheduled dynamically.
+ * \param [in] batch_size  Patches per batch (the last one may be smaller).
+ *                         If <= 0, the whole level is a single batch when
+ *                         running on one thread;  otherwise it is split
+ *                         into a few batches per thread.
+ * \param [in] patch_mask  If not NULL, only patches with
+ *                         patch_mask[local patch index] == mask_value
+ *                         are visited.
+ * Remaining arguments as in fclaw3d_domain_iterate_level_reduce.
+ */
+void fclaw3d_domain_iterate_level_batched (struct fclaw3d_domain * domain,
+                                           int level, int batch_size,
+                                           const int *patch_mask,
+                                           int mask_value,
+                                           fclaw3d_patch_batch_callback_t pcb,
+                                           void *user, void *result,
+                                           size_t result_size,
+                                           fclaw3d_reduce_combine_t combine);
+
 /* below are the functions needed for dimension independence */
 
 /** safeguard value for dimension-independent domain */
@@ -28,6 +28,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <forestclaw3d.h>  /* Needed to declare callbacks (below) */
 #include <fclaw3d_map.h>   /* Needed to store the map context */
+#include <fclaw3d_domain.h>  /* Needed to declare reduction callbacks */
 
 #include <fclaw_timer.h>   /* Needed to create statically allocated array of timers */
 
@@ -66,12 +67,22 @@ struct fclaw3d_global
     int count_grids_per_proc;
     int count_grids_remote_boundary;
     int count_grids_local_boundary;
+    double count_wire_bytes_saved;  /**< Bytes saved by compact ghost/partition packing */
+    double count_patch_cost;  /**< Local patch cost per coarse step at last partition */
     fclaw2d_timer_t timers[FCLAW2D_TIMER_COUNT];
 
     /* Time at start of each subcycled time step */
     double curr_time;
     double curr_dt;
 
+    /** Solvers tag patches for refinement in the update that ends at
+        tag_in_update_time, since the run loop regrids right after it */
+    int tag_in_update;
+    double tag_in_update_time;
+
+    /** Regrids since the last partition (see fclaw2d_partition_needed) */
+    int partition_skipped;
+
     sc_MPI_Comm mpicomm;
     int mpisize;              /**< Size of communicator. */
     int mpirank;              /**< Rank of this process in \b mpicomm. */
@@ -93,6 +104,9 @@ struct fclaw3d_global
     struct fclaw3d_diagnostics_accumulator *acc;
 #endif
 
+    /** Per-thread scratch memory, see fclaw3d_global_get_scratch. */
+    struct fclaw3d_global_scratch *scratch;
+
     void *user;
 };
 
@@ -110,6 +124,27 @@ fclaw3d_global_t* fclaw3d_global_new_comm (sc_MPI_Comm mpicomm,
 
 void fclaw3d_global_destroy (fclaw3d_global_t * glob);
 
+/** Number of scratch buffers each thread may hold at the same time. */
+#define FCLAW3D_GLOBAL_SCRATCH_SLOTS 8
+
+/** Borrow a scratch buffer for the calling thread.
+ * Solver step routines use this in place of allocating and freeing
+ * their work arrays for every patch.  Each (thread, slot) pair owns one
+ * buffer that grows to the largest size requested and is reused after
+ * that; it is released in fclaw3d_global_destroy.  Threads of nested or
+ * later, larger teams get buffers of their own.  The contents are
+ * undefined on return and remain valid until the same thread asks for
+ * the same slot again.
+ * \param [in] glob    Global context.
+ * \param [in] slot    Buffer index in [0, FCLAW3D_GLOBAL_SCRATCH_SLOTS).
+ *                     Use distinct slots for buffers that are live
+ *                     simultaneously.
+ * \param [in] count   Minimum number of doubles required.
+ * \return             Buffer of at least \a count doubles.
+ */
+double *fclaw3d_global_get_scratch (fclaw3d_global_t * glob, int slot,
+                                    size_t count);
+
 void fclaw3d_global_store_domain (fclaw3d_global_t* glob,
                                   struct fclaw3d_domain* domain);
 
@@ -158,6 +193,40 @@ void fclaw3d_global_iterate_adapted (fclaw3d_global_t * glob,
 void fclaw3d_global_iterate_level_mthread (fclaw3d_global_t * glob, int level,
                                            fclaw3d_patch_callback_t pcb, void *user);
 
+void fclaw3d_global_iterate_patches_mthread (fclaw3d_global_t * glob,
+                                             fclaw3d_patch_callback_t pcb,
+                                             void *user);
+
+void fclaw3d_global_iterate_adapted_mthread (fclaw3d_global_t * glob,
+                                             struct fclaw3d_domain* new_domain,
+                                             fclaw3d_match_callback_t mcb,
+                                             void *user);
+
+void fclaw3d_global_iterate_partitioned_mthread (fclaw3d_global_t * glob,
+                                                 struct fclaw3d_domain * new_domain,
+                                                 fclaw3d_transfer_callback_t tcb,
+                                                 void *user);
+
+/** Level iteration with thread-local reductions, see
+ * fclaw3d_domain_iterate_level_reduce.  The callback receives a
+ * fclaw3d_global_iterate_t as user argument. */
+void fclaw3d_global_iterate_level_reduce (fclaw3d_global_t * glob, int level,
+                                          fclaw3d_patch_reduce_callback_t pcb,
+                                          void *user, void *result,
+                                          size_t result_size,
+                                          fclaw3d_reduce_combine_t combine);
+
+/** Batched level iteration, see fclaw3d_domain_iterate_level_batched.
+ * The callback receives a fclaw3d_global_iterate_t as user argument. */
+void fclaw3d_global_iterate_level_batched (fclaw3d_global_t * glob, int level,
+                                           int batch_size,
+                                           const int *patch_mask,
+                                           int mask_value,
+                                           fclaw3d_patch_batch_callback_t pcb,
+                                           void *user, void *result,
+                                           size_t result_size,
+                                           fclaw3d_reduce_combine_t combine);
+
 void fclaw3d_global_iterate_partitioned (fclaw3d_global_t * glob,
                                          struct fclaw3d_domain * new_domain,
                                          fclaw3d_transfer_callback_t tcb,
@@ -103,6 +103,17 @@ struct fclaw3d_patch_data
     void *user_patch;
     /** Additional user data */
     void *user_data;
+
+    /** Cost gathered over cost_updates updates (see fclaw3d_patch_add_cost) */
+    double cost;
+    /** Number of updates the cost was gathered over */
+    double cost_updates;
+
+    /** Coarse patch kept for deferred interpolation; set on the first
+        fine patch only (see fclaw3d_patch_defer_interpolate2fine) */
+    struct fclaw3d_patch *refine_parent;
+    /** True while this fine patch waits for deferred interpolation */
+    int refine_deferred;
 };
 
 /**
@@ -619,6 +630,83 @@ void fclaw3d_patch_average2coarse(struct fclaw3d_global *glob,
                                   int blockno, int fine0_patchno,
                                   int coarse_patchno);
 
+/**
+ * @brief Keep a coarse patch to interpolate its fine patches later
+ *
+ * The coarse patch data moves to a patch kept with the first fine patch,
+ * so it can follow the fine patches through a partition and be
+ * interpolated on their new owner.  The coarse patch is left without
+ * patch data.
+ *
+ * @param[in] glob the global context
+ * @param[in,out] coarse_patch the coarse patch context
+ * @param[in,out] fine_patches the fine patch contexts
+ */
+void fclaw3d_patch_defer_interpolate2fine(struct fclaw3d_global *glob,
+                                         struct fclaw3d_patch* coarse_patch,
+                                         struct fclaw3d_patch* fine_patches);
+
+/**
+ * @brief Attach a coarse patch for deferred interpolation
+ *
+ * Used for a coarse patch received with the first of its fine patches.
+ *
+ * @param[in] glob the global context
+ * @param[in] coarse_patch allocated with FCLAW_ALLOC and owned by the fine
+ *            patch after the call
+ * @param[in,out] fine_patch the first fine patch context
+ */
+void fclaw3d_patch_set_deferred_parent(struct fclaw3d_global *glob,
+                                      struct fclaw3d_patch* coarse_patch,
+                                      struct fclaw3d_patch* fine_patch);
+
+/**
+ * @brief Get the coarse patch kept for deferred interpolation
+ *
+ * @param[in] glob the global context
+ * @param[in] fine_patch the fine patch context
+ * @return the coarse patch if fine_patch is the first of its siblings
+ *         waiting for interpolation, NULL otherwise
+ */
+struct fclaw3d_patch* fclaw3d_patch_get_deferred_parent(struct fclaw3d_global *glob,
+                                                   struct fclaw3d_patch* fine_patch);
+
+/**
+ * @brief Detach the coarse patch kept for deferred interpolation
+ *
+ * @param[in] glob the global context
+ * @param[in,out] fine_patch the first fine patch context
+ * @return the coarse patch, now owned by the caller
+ */
+struct fclaw3d_patch* fclaw3d_patch_take_deferred_parent(struct fclaw3d_global *glob,
+                                                    struct fclaw3d_patch* fine_patch);
+
+/**
+ * @brief Check if a fine patch waits for deferred interpolation
+ *
+ * @param[in] glob the global context
+ * @param[in] fine_patch the fine patch context
+ * @return true if the patch has not been interpolated yet
+ */
+int fclaw3d_patch_is_deferred(struct fclaw3d_global *glob,
+                             struct fclaw3d_patch* fine_patch);
+
+/**
+ * @brief Interpolate fine patches from their kept coarse patch
+ *
+ * The coarse patch is deleted afterwards.
+ *
+ * @param[in] glob the global context
+ * @param[in,out] fine_patches the fine patch contexts; the first one
+ *                holds the coarse patch
+ * @param[in] blockno the block number
+ * @param[in] fine0_patchno the patch number of the first fine patch
+ */
+void fclaw3d_patch_interpolate2fine_deferred(struct fclaw3d_global *glob,
+                                            struct fclaw3d_patch* fine_patches,
+                                            int blockno,
+                                            int fine0_patchno);
+
 ///@}
 /* ------------------------------------------------------------------------------------ */
 ///                         @name Parallel Ghost Patches
@@ -751,6 +839,84 @@ void fclaw3d_patch_partition_unpack(struct fclaw3d_global *glob,
  */
 size_t fclaw3d_patch_partition_packsize(struct fclaw3d_global* glob);
 
+/**
+ * @brief Lay out the data of the local patches level by level
+ *
+ * Called once the local patches of a new domain are final, that is after
+ * regridding and partitioning and before the ghost patches are built.
+ * Does nothing if the patch implementation does not provide this.
+ *
+ * @param[in] glob the global context
+ */
+void fclaw3d_patch_pack_levels(struct fclaw3d_global* glob);
+
+/**
+ * @brief Report the memory held by patch data, by field and level
+ *
+ * Called with the end-of-run timing report; collective over the domain.
+ * Does nothing if the patch implementation does not provide this.
+ *
+ * @param[in] glob the global context
+ */
+void fclaw3d_patch_memory_report(struct fclaw3d_global* glob);
+
+/**
+ * @brief Release memory that patch data no longer needs
+ *
+ * Called at the end of a regrid that changed the domain, once the new
+ * patches and ghost patches are set up.
+ * Does nothing if the patch implementation does not provide this.
+ *
+ * @param[in] glob the global context
+ */
+void fclaw3d_patch_release_memory(struct fclaw3d_global* glob);
+
+///@}
+/* ------------------------------------------------------------------------------------ */
+///                         @name Cost model
+/* ------------------------------------------------------------------------------------ */
+///@{
+
+/**
+ * @brief Add to the cost of the current update of a patch
+ *
+ * With the option partition-cost, patch costs are used to weight the
+ * partition.  Solvers add measured update time (partition-cost=1);
+ * users may add their own work units instead (partition-cost=2).
+ *
+ * @param[in] glob the global context
+ * @param[in,out] patch the patch context
+ * @param[in] cost the cost to add
+ */
+void fclaw3d_patch_add_cost(struct fclaw3d_global* glob,
+                             struct fclaw3d_patch* patch,
+                             double cost);
+
+/**
+ * @brief Get the average cost of one update of a patch
+ *
+ * @param[in] glob the global context
+ * @param[in] patch the patch context
+ * @return the average cost, or the cost gathered so far if the patch
+ *         has not been updated
+ */
+double fclaw3d_patch_get_cost(struct fclaw3d_global* glob,
+                               struct fclaw3d_patch* patch);
+
+/**
+ * @brief Start the cost of a patch from an estimate
+ *
+ * Used for patches created by regridding, which inherit the cost of the
+ * patches they replace.  The estimate counts as a single update.
+ *
+ * @param[in] glob the global context
+ * @param[in,out] patch the patch context
+ * @param[in] cost the average cost of one update, or 0 if unknown
+ */
+void fclaw3d_patch_set_cost(struct fclaw3d_global* glob,
+                             struct fclaw3d_patch* patch,
+                             double cost);
+
 
 ///@}
 /* ------------------------------------------------------------------------------------ */
@@ -978,6 +1144,10 @@ typedef void (*fclaw3d_patch_restore_step_t)(struct fclaw3d_global *glob,
 typedef void (*fclaw3d_patch_save_step_t)(struct fclaw3d_global *glob,
                                           struct fclaw3d_patch* this_patch);
 
+/** @copydoc fclaw2d_patch_begin_update_t */
+typedef void (*fclaw3d_patch_begin_update_t)(struct fclaw3d_global *glob,
+                                             struct fclaw3d_patch* this_patch);
+
 
 ///@}
 /* ------------------------------------------------------------------------------------ */
@@ -1320,6 +1490,15 @@ typedef void (*fclaw3d_patch_remote_ghost_delete_t)(void *user_patch);
 /** @copydoc fclaw2d_patch_partition_packsize() */
 typedef size_t (*fclaw3d_patch_partition_packsize_t)(struct fclaw3d_global* glob);
 
+/** @copydoc fclaw2d_patch_pack_levels() */
+typedef void (*fclaw3d_patch_pack_levels_t)(struct fclaw3d_global* glob);
+
+/** @copydoc fclaw2d_patch_memory_report() */
+typedef void (*fclaw3d_patch_memory_report_t)(struct fclaw3d_global* glob);
+
+/** @copydoc fclaw2d_patch_release_memory() */
+typedef void (*fclaw3d_patch_release_memory_t)(struct fclaw3d_global* glob);
+
 
 /** @copydoc fclaw2d_patch_partition_pack() */
 typedef void (*fclaw3d_patch_partition_pack_t)(struct fclaw3d_global *glob,
@@ -1462,6 +1641,8 @@ struct fclaw3d_patch_vtable
     fclaw3d_patch_restore_step_t          restore_step;
     /** @copybrief ::fclaw2d_patch_save_step_t */
     fclaw3d_patch_save_step_t             save_step;
+    /** @copybrief ::fclaw2d_patch_begin_update_t */
+    fclaw3d_patch_begin_update_t          begin_update;
     /** @copybrief ::fclaw2d_patch_setup_timeinterp_t */
     fclaw3d_patch_setup_timeinterp_t      setup_timeinterp;
 
@@ -1569,6 +1750,12 @@ struct fclaw3d_patch_vtable
     fclaw3d_patch_partition_unpack_t       partition_unpack;
     /** @copybrief ::fclaw2d_patch_partition_packsize_t */
     fclaw3d_patch_partition_packsize_t     partition_packsize;
+    /** @copybrief ::fclaw2d_patch_pack_levels_t */
+    fclaw3d_patch_pack_levels_t           pack_levels;
+    /** @copybrief ::fclaw2d_patch_memory_report_t */
+    fclaw3d_patch_memory_report_t         memory_report;
+    /** @copybrief ::fclaw2d_patch_release_memory_t */
+    fclaw3d_patch_release_memory_t        release_memory;
 
     /** @} */
 
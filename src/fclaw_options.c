@@ -71,6 +71,10 @@ fclaw_register (fclaw_options_t* fclaw_opt, sc_options_t * opt)
     sc_options_add_bool (opt, 0, "reduce-cfl", &fclaw_opt->reduce_cfl, 1,
                            "Get maximum CFL over all processors [T]");
 
+    sc_options_add_bool (opt, 0, "speculative-cfl", &fclaw_opt->speculative_cfl, 0,
+                         "Reduce the CFL non-blocking, overlapped with the " \
+                         "next step; retake both steps if exceeded [F]");
+
     sc_options_add_bool (opt, 0, "use_fixed_dt", &fclaw_opt->use_fixed_dt, 0,
                          "Use fixed coarse grid time step [F]");
 
@@ -105,6 +109,35 @@ fclaw_register (fclaw_options_t* fclaw_opt, sc_options_t * opt)
     sc_options_add_bool (opt, 0, "weighted_partition", &fclaw_opt->weighted_partition, 1,
                          "Weight grids when partitioning [T]");
 
+    sc_options_add_int (opt, 0, "partition-cost", &fclaw_opt->partition_cost, 0,
+                        "Patch cost used to weight the partition : " \
+                        "0 - level heuristic; 1 - measured update time; " \
+                        "2 - user work (fclaw2d_patch_add_cost) [0]");
+
+    sc_options_add_double (opt, 0, "partition-imbalance",
+                           &fclaw_opt->partition_imbalance, 0,
+                           "Repartition after a regrid only if the weighted patch "
+                           "count on the most loaded rank exceeds the mean by "
+                           "this fraction; 0 always repartitions [0]");
+
+    sc_options_add_int (opt, 0, "partition-max-skip",
+                        &fclaw_opt->partition_max_skip, 0,
+                        "With partition-imbalance, repartition after at most "
+                        "this many skipped regrids; 0 for no limit [0]");
+
+    sc_options_add_bool (opt, 0, "refine-on-destination",
+                         &fclaw_opt->refine_on_destination, 0,
+                         "Send the coarse patch of newly refined patches that "
+                         "change owner in the partition after a regrid, and "
+                         "interpolate on the new owner [F]");
+
+    sc_options_add_bool (opt, 0, "partition-compress",
+                         &fclaw_opt->partition_compress, 0,
+                         "Send patches that change owner in the partition "
+                         "with a lossless byte-shuffle and run-length "
+                         "encoding.  Received patches then copy their data "
+                         "instead of keeping the receive buffer [F]");
+
     /* ------------------------------ Conservation fix -------------------------------- */
 
     sc_options_add_bool (opt, 0, "time-sync", &fclaw_opt->time_sync, 0,
@@ -220,6 +253,18 @@ fclaw_register (fclaw_options_t* fclaw_opt, sc_options_t * opt)
                            &fclaw_opt->coarsen_threshold,
                            0.1, "Coarsening threshold [0.1]");
 
+    sc_options_add_double (opt, 0, "tag-reuse-tolerance", 
+                           &fclaw_opt->tag_reuse_tolerance,
+                           0, "Reuse the last refine/coarsen tags of patches whose "
+                           "solution changed by less than this since [0]");
+
+    sc_options_add_bool (opt, 0, "tag-in-update", 
+                         &fclaw_opt->tag_in_update, 0,
+                         "Tag patches for refinement right after their last update "
+                         "before a regrid.  Only for tagging routines that read no "
+                         "ghost cells (clawpatch vtable tag4refinement_interior_only); "
+                         "others tag at the regrid.  Not with GeoClaw [F]");
+
     /* ---------------------------------- Diagnostics --------------------------------- */
 
     sc_options_add_bool (opt, 0, "run-user-diagnostics",
@@ -267,6 +312,11 @@ fclaw_register (fclaw_options_t* fclaw_opt, sc_options_t * opt)
                         &fclaw_opt->ghost_patch_pack_numextrafields,
                         0, "Number of extra fields to pack [0]");
 
+    sc_options_add_bool (opt, 0, "overlap-ghost-exchange",
+                         &fclaw_opt->overlap_ghost_exchange, 0,
+                         "Update interior patches while ghost patches are " \
+                         "exchanged [F]");
+
     /* ---------------------------------- Debugging ----------------------------------- */
 
     sc_options_add_bool (opt, 0, "trapfpe", &fclaw_opt->trapfpe,1,
@@ -299,6 +349,14 @@ fclaw_register (fclaw_options_t* fclaw_opt, sc_options_t * opt)
     sc_options_add_bool (opt, 0, "manifold", &fclaw_opt->manifold, 0,
                          "Solution is on manifold [F]");
 
+    sc_options_add_bool (opt, 0, "share-metric", &fclaw_opt->share_metric, 0,
+                         "Share normals, tangents, edge lengths and curvature " \
+                         "among patches of a block and level (affine maps only) [F]");
+
+    sc_options_add_int (opt, 0, "metric-cache-size", &fclaw_opt->metric_cache_size, 0,
+                        "Number of patches whose metric terms are kept for reuse " \
+                        "after regridding (0 = off) [0]");
+
     sc_options_add_int (opt, 0, "mi", &fclaw_opt->mi, 1,
                         "Number of blocks in x direction [1]");
 
@@ -386,6 +444,18 @@ fclaw_options_check (fclaw_options_t * fclaw_opt)
         return FCLAW_EXIT_ERROR;
     }
 
+    if (fclaw_opt->partition_cost < 0 || fclaw_opt->partition_cost > 2)
+    {
+        fclaw_global_essentialf("Options : partition-cost must be 0, 1 or 2\n");
+        return FCLAW_EXIT_ERROR;
+    }
+    if (fclaw_opt->partition_imbalance < 0 || fclaw_opt->partition_max_skip < 0)
+    {
+        fclaw_global_essentialf("Options : partition-imbalance and " \
+                                "partition-max-skip must be non-negative\n");
+        return FCLAW_EXIT_ERROR;
+    }
+
     /* TODO: move these blocks to the beginning of forestclaw's control flow */
     if (fclaw_opt->mpi_debug)
     {
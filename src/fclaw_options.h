@@ -140,6 +140,7 @@ struct fclaw_options
     double max_cfl;
     double desired_cfl;
     int reduce_cfl;   /* Do an all-reduce to get max. cfl */
+    int speculative_cfl;  /* Overlap the cfl all-reduce with the next step */
     double *tout;
 
     /* Refinement parameters */
@@ -150,6 +151,9 @@ struct fclaw_options
     int smooth_refine;
     int smooth_level;
     double refine_threshold;
+    double tag_reuse_tolerance;  /**< Reuse tags of patches that changed less */
+    int tag_in_update;  /**< Tag for refinement in the update before a regrid,
+                             if the tagging reads no ghost cells */
 
     /* Conservation */
     int time_sync;
@@ -162,6 +166,8 @@ struct fclaw_options
 
     /* Mapping functions */
     int manifold;
+    int share_metric;  /**< Share metric basis terms for affine maps */
+    int metric_cache_size;  /**< Patches whose metric terms are kept across regrids */
     int mi;
     int mj;
     int periodic_x;
@@ -180,6 +186,10 @@ struct fclaw_options
     /* Return after each time step  */
     int advance_one_step;
 
+    /* Update patches away from the parallel boundary while ghost patches
+       are being exchanged */
+    int overlap_ghost_exchange;
+
     /* nout, when used with outstyle option 3 refers to number of fine grid steps */
     int outstyle_uses_maxlevel;
 
@@ -241,6 +251,11 @@ struct fclaw_options
     double vtkspace; /**< between 0. and 1. to separate patches visually */
 
     int weighted_partition;            /**< Use weighted partition. */
+    int partition_cost;  /**< Patch costs: 0 none, 1 measured update time, 2 user work */
+    double partition_imbalance;  /**< Repartition after regrid only above this imbalance */
+    int partition_max_skip;      /**< Repartition at least every this many regrids */
+    int refine_on_destination;   /**< Interpolate refined patches on their new owner */
+    int partition_compress;      /**< Compress patches sent in the partition */
 
     int is_registered;
     int is_unpacked; /**< True if options structure was unpacked from buffer */
@@ -202,6 +202,14 @@ fclaw2d_timer_report(fclaw2d_global_t *glob)
     sc_stats_set1 (&stats[FCLAW2D_TIMER_GRIDS_REMOTE_BOUNDARY],grb,
                    "GRIDS_REMOTE_BOUNDARY");
 
+    /* Bytes not sent because of compact ghost and partition packing */
+    sc_stats_set1 (&stats[FCLAW2D_TIMER_WIRE_BYTES_SAVED],
+                   glob->count_wire_bytes_saved,"WIRE_BYTES_SAVED");
+
+    /* Measured or user patch cost; min/max across ranks show the imbalance */
+    sc_stats_set1 (&stats[FCLAW2D_TIMER_PATCH_COST],
+                   glob->count_patch_cost,"PATCH_COST");
+
     int time_ex1 = glob->timers[FCLAW2D_TIMER_REGRID].cumulative +
                    glob->timers[FCLAW2D_TIMER_ADVANCE].cumulative +
                    glob->timers[FCLAW2D_TIMER_GHOSTFILL].cumulative +
@@ -307,6 +315,8 @@ fclaw2d_timer_report(fclaw2d_global_t *glob)
     FCLAW2D_STATS_SET_GROUP(stats,GRIDS_INTERIOR,        COUNTERS2);
     FCLAW2D_STATS_SET_GROUP(stats,GRIDS_LOCAL_BOUNDARY,  COUNTERS2);
     FCLAW2D_STATS_SET_GROUP(stats,GRIDS_REMOTE_BOUNDARY, COUNTERS2);
+    FCLAW2D_STATS_SET_GROUP(stats,WIRE_BYTES_SAVED,      COUNTERS2);
+    FCLAW2D_STATS_SET_GROUP(stats,PATCH_COST,            COUNTERS2);
 
     FCLAW2D_STATS_SET_GROUP(stats,REGRID_BUILD,          REGRID);
     FCLAW2D_STATS_SET_GROUP(stats,REGRID_TAGGING,        REGRID);
@@ -73,6 +73,8 @@ typedef enum
     FCLAW2D_TIMER_GRIDS_INTERIOR,
     FCLAW2D_TIMER_GRIDS_LOCAL_BOUNDARY,
     FCLAW2D_TIMER_GRIDS_REMOTE_BOUNDARY,
+    FCLAW2D_TIMER_WIRE_BYTES_SAVED,
+    FCLAW2D_TIMER_PATCH_COST,
     FCLAW2D_TIMER_REGRID_BUILD,
     FCLAW2D_TIMER_REGRID_TAGGING,
     FCLAW2D_TIMER_TIMESYNC,
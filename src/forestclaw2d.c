@@ -27,14 +27,19 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <forestclaw2d.h>
 #include <p4est_bits.h>
 #include <p4est_wrap.h>
+#include <p4est_communication.h>
 #else
 #include <forestclaw3d.h>
 #include <p8est_bits.h>
 #include <p8est_wrap.h>
+#include <p8est_communication.h>
 #endif
 
 #ifndef P4_TO_P8
 #define FCLAW2D_DOMAIN_TAG_SERIALIZE 4526
+#define FCLAW2D_DOMAIN_TAG_GHOST_PERSISTENT 4528
+#define FCLAW2D_DOMAIN_TAG_TRANSFER_SIZES 4530
+#define FCLAW2D_DOMAIN_TAG_TRANSFER_DATA 4532
 
 const fclaw2d_patch_flags_t fclaw2d_patch_block_face_flags[4] = {
     FCLAW2D_PATCH_ON_BLOCK_FACE_0,
@@ -45,6 +50,9 @@ const fclaw2d_patch_flags_t fclaw2d_patch_block_face_flags[4] = {
 
 #else
 #define FCLAW2D_DOMAIN_TAG_SERIALIZE 4527
+#define FCLAW2D_DOMAIN_TAG_GHOST_PERSISTENT 4529
+#define FCLAW2D_DOMAIN_TAG_TRANSFER_SIZES 4531
+#define FCLAW2D_DOMAIN_TAG_TRANSFER_DATA 4533
 #endif
 
 double
@@ -60,6 +68,41 @@ fclaw2d_domain_global_maximum (fclaw2d_domain_t * domain, double d)
     return gd;
 }
 
+void
+fclaw2d_domain_global_maximum_begin (fclaw2d_domain_t * domain, double d,
+                                     fclaw2d_domain_reduce_t * r)
+{
+    r->local = d;
+    r->global = d;
+    r->inside_async = 1;
+#ifdef FCLAW_ENABLE_MPI
+    {
+        int mpiret;
+
+        mpiret = MPI_Iallreduce (&r->local, &r->global, 1, sc_MPI_DOUBLE,
+                                 sc_MPI_MAX, domain->mpicomm, &r->request);
+        SC_CHECK_MPI (mpiret);
+    }
+#endif
+}
+
+double
+fclaw2d_domain_global_maximum_end (fclaw2d_domain_t * domain,
+                                   fclaw2d_domain_reduce_t * r)
+{
+    FCLAW_ASSERT (r->inside_async);
+#ifdef FCLAW_ENABLE_MPI
+    {
+        int mpiret;
+
+        mpiret = sc_MPI_Wait (&r->request, sc_MPI_STATUS_IGNORE);
+        SC_CHECK_MPI (mpiret);
+    }
+#endif
+    r->inside_async = 0;
+    return r->global;
+}
+
 double
 fclaw2d_domain_global_sum (fclaw2d_domain_t * domain, double d)
 {
@@ -1703,6 +1746,112 @@ fclaw2d_domain_free_after_partition (fclaw2d_domain_t * domain,
     p4est_reset_data (wrap->p4est, 0, NULL, wrap->p4est->user_pointer);
 }
 
+struct fclaw2d_domain_kept
+{
+    sc_mempool_t *pool;
+    int refcount;
+};
+
+fclaw2d_domain_kept_t *
+fclaw2d_domain_keep_after_partition (fclaw2d_domain_t * domain)
+{
+    p4est_wrap_t *wrap = (p4est_wrap_t *) domain->pp;
+    fclaw2d_domain_kept_t *kept;
+
+    FCLAW_ASSERT (wrap->p4est->data_size > 0);
+
+    /* Detach the pool so that p4est_reset_data does not destroy it */
+    kept = FCLAW_ALLOC (fclaw2d_domain_kept_t, 1);
+    kept->pool = wrap->p4est->user_data_pool;
+    kept->refcount = 1;
+    wrap->p4est->user_data_pool = NULL;
+
+    return kept;
+}
+
+void
+fclaw2d_domain_kept_ref (fclaw2d_domain_kept_t * kept)
+{
+#pragma omp critical(fclaw2d_domain_kept)
+    {
+        FCLAW_ASSERT (kept->refcount > 0);
+        ++kept->refcount;
+    }
+}
+
+void
+fclaw2d_domain_kept_unref (fclaw2d_domain_kept_t * kept)
+{
+    int remaining;
+
+#pragma omp critical(fclaw2d_domain_kept)
+    {
+        FCLAW_ASSERT (kept->refcount > 0);
+        remaining = --kept->refcount;
+    }
+    if (remaining == 0)
+    {
+        sc_mempool_destroy (kept->pool);
+        FCLAW_FREE (kept);
+    }
+}
+
+int64_t *
+fclaw2d_domain_save_partition (fclaw2d_domain_t * domain)
+{
+    p4est_wrap_t *wrap = (p4est_wrap_t *) domain->pp;
+    int64_t *offsets;
+    int i;
+
+    offsets = FCLAW_ALLOC (int64_t, domain->mpisize + 1);
+    for (i = 0; i <= domain->mpisize; ++i)
+    {
+        offsets[i] = (int64_t) wrap->p4est->global_first_quadrant[i];
+    }
+    return offsets;
+}
+
+void
+fclaw2d_domain_transfer_after_partition (fclaw2d_domain_t * new_domain,
+                                         const int64_t * old_offsets,
+                                         const void *src_data,
+                                         const int *src_sizes,
+                                         void **dest_data, int **dest_sizes)
+{
+    p4est_wrap_t *wrap = (p4est_wrap_t *) new_domain->pp;
+    p4est_gloidx_t *src_gfq;
+    size_t total;
+    int i;
+
+    FCLAW_ASSERT (new_domain->pp_owned);
+    FCLAW_ASSERT (new_domain->just_partitioned);
+
+    src_gfq = FCLAW_ALLOC (p4est_gloidx_t, new_domain->mpisize + 1);
+    for (i = 0; i <= new_domain->mpisize; ++i)
+    {
+        src_gfq[i] = (p4est_gloidx_t) old_offsets[i];
+    }
+
+    /* the receivers need to know the sizes before the data */
+    *dest_sizes = FCLAW_ALLOC (int, new_domain->local_num_patches);
+    p4est_transfer_fixed (wrap->p4est->global_first_quadrant, src_gfq,
+                          new_domain->mpicomm,
+                          FCLAW2D_DOMAIN_TAG_TRANSFER_SIZES,
+                          *dest_sizes, src_sizes, sizeof (int));
+
+    for (total = 0, i = 0; i < new_domain->local_num_patches; ++i)
+    {
+        total += (size_t) (*dest_sizes)[i];
+    }
+    *dest_data = FCLAW_ALLOC (char, total);
+    p4est_transfer_custom (wrap->p4est->global_first_quadrant, src_gfq,
+                           new_domain->mpicomm,
+                           FCLAW2D_DOMAIN_TAG_TRANSFER_DATA,
+                           *dest_data, *dest_sizes, src_data, src_sizes);
+
+    FCLAW_FREE (src_gfq);
+}
+
 fclaw2d_domain_exchange_t *
 fclaw2d_domain_allocate_before_exchange (fclaw2d_domain_t * domain,
                                          size_t data_size)
@@ -1731,10 +1880,239 @@ fclaw2d_domain_allocate_before_exchange (fclaw2d_domain_t * domain,
     e->async_state = NULL;
     e->by_levels = 0;
     e->inside_async = 0;
+    e->persistent = NULL;
 
     return e;
 }
 
+#ifdef FCLAW_ENABLE_MPI
+
+/* Persistent requests for one range of exchanged levels */
+typedef struct persistent_range
+{
+    int minlevel, maxlevel;
+    int num_requests;
+    sc_MPI_Request *requests;   /* receives first, then sends */
+}
+persistent_range_t;
+
+/* Exchange pattern between two regrids.  Per peer process, the patches to
+   send and to receive are sorted by level.  Messages to and from a peer
+   contain the patches in the same order on both sides, so the patches of a
+   consecutive range of levels are a contiguous piece of each message. */
+typedef struct persistent_exchange
+{
+    p4est_ghost_t *ghost;
+    int num_peers;
+    int num_levels;
+    size_t data_size;
+
+    /* Patch offsets per (peer, level), peer-major, num_peers * num_levels + 1 */
+    int *send_offset;
+    int *recv_offset;
+    int *send_mirror;           /* Mirror number for each send slot */
+    int *recv_ghost;            /* Ghost number for each receive slot */
+    char *send_buffer;
+    char *recv_buffer;
+
+    sc_array_t ranges;          /* One persistent_range_t per level range */
+    persistent_range_t *active;
+}
+persistent_exchange_t;
+
+static void
+persistent_sort_by_level (sc_array_t * quadrants, int num_peers,
+                          int num_levels, const p4est_locidx_t * proc_offsets,
+                          const p4est_locidx_t * proc_index,
+                          int *offset, int *index)
+{
+    int q, k, slot;
+    int *cursor;
+    p4est_locidx_t j;
+    p4est_quadrant_t *quad;
+
+    /* count patches per (peer, level) */
+    memset (offset, 0, sizeof (int) * (num_peers * num_levels + 1));
+    for (q = 0; q < num_peers; ++q)
+    {
+        for (j = proc_offsets[q]; j < proc_offsets[q + 1]; ++j)
+        {
+            k = proc_index != NULL ? (int) proc_index[j] : (int) j;
+            quad = p4est_quadrant_array_index (quadrants, k);
+            FCLAW_ASSERT ((int) quad->level < num_levels);
+            ++offset[q * num_levels + quad->level + 1];
+        }
+    }
+    for (slot = 0; slot < num_peers * num_levels; ++slot)
+    {
+        offset[slot + 1] += offset[slot];
+    }
+
+    /* stable fill, the order within a level follows the p4est messages */
+    cursor = FCLAW_ALLOC (int, num_peers * num_levels);
+    memcpy (cursor, offset, sizeof (int) * num_peers * num_levels);
+    for (q = 0; q < num_peers; ++q)
+    {
+        for (j = proc_offsets[q]; j < proc_offsets[q + 1]; ++j)
+        {
+            k = proc_index != NULL ? (int) proc_index[j] : (int) j;
+            quad = p4est_quadrant_array_index (quadrants, k);
+            index[cursor[q * num_levels + quad->level]++] = k;
+        }
+    }
+    FCLAW_FREE (cursor);
+}
+
+static persistent_range_t *
+persistent_get_range (fclaw2d_domain_t * domain, persistent_exchange_t * pe,
+                      int minlevel, int maxlevel)
+{
+    size_t zz;
+    int q, count, first, mpiret;
+    int L = pe->num_levels;
+    persistent_range_t *r;
+
+    for (zz = 0; zz < pe->ranges.elem_count; ++zz)
+    {
+        r = (persistent_range_t *) sc_array_index (&pe->ranges, zz);
+        if (r->minlevel == minlevel && r->maxlevel == maxlevel)
+        {
+            return r;
+        }
+    }
+
+    /* first use of this level range: create its requests */
+    r = (persistent_range_t *) sc_array_push (&pe->ranges);
+    r->minlevel = minlevel;
+    r->maxlevel = maxlevel;
+    r->num_requests = 0;
+    r->requests = FCLAW_ALLOC (sc_MPI_Request, 2 * pe->num_peers);
+    for (q = 0; q < pe->num_peers; ++q)
+    {
+        first = pe->recv_offset[q * L + minlevel];
+        count = pe->recv_offset[q * L + maxlevel + 1] - first;
+        if (count > 0)
+        {
+            mpiret = MPI_Recv_init (pe->recv_buffer + first * pe->data_size,
+                                    count * (int) pe->data_size, sc_MPI_BYTE,
+                                    q, FCLAW2D_DOMAIN_TAG_GHOST_PERSISTENT,
+                                    domain->mpicomm,
+                                    &r->requests[r->num_requests++]);
+            SC_CHECK_MPI (mpiret);
+        }
+    }
+    for (q = 0; q < pe->num_peers; ++q)
+    {
+        first = pe->send_offset[q * L + minlevel];
+        count = pe->send_offset[q * L + maxlevel + 1] - first;
+        if (count > 0)
+        {
+            mpiret = MPI_Send_init (pe->send_buffer + first * pe->data_size,
+                                    count * (int) pe->data_size, sc_MPI_BYTE,
+                                    q, FCLAW2D_DOMAIN_TAG_GHOST_PERSISTENT,
+                                    domain->mpicomm,
+                                    &r->requests[r->num_requests++]);
+            SC_CHECK_MPI (mpiret);
+        }
+    }
+    return r;
+}
+
+#endif /* FCLAW_ENABLE_MPI */
+
+void
+fclaw2d_domain_ghost_exchange_persistent_setup (fclaw2d_domain_t * domain,
+                                                fclaw2d_domain_exchange_t * e)
+{
+#ifdef FCLAW_ENABLE_MPI
+    p4est_wrap_t *wrap = (p4est_wrap_t *) domain->pp;
+    p4est_ghost_t *ghost = wrap->match_aux ? wrap->ghost_aux : wrap->ghost;
+    persistent_exchange_t *pe;
+    int nslots;
+
+    FCLAW_ASSERT (e->persistent == NULL);
+    FCLAW_ASSERT (!e->inside_async);
+    FCLAW_ASSERT (e->num_exchange_patches == (int) ghost->mirrors.elem_count);
+    FCLAW_ASSERT (e->num_ghost_patches == (int) ghost->ghosts.elem_count);
+
+    if (domain->mpisize == 1)
+    {
+        return;
+    }
+
+    pe = FCLAW_ALLOC (persistent_exchange_t, 1);
+    pe->ghost = ghost;
+    pe->num_peers = domain->mpisize;
+    pe->num_levels = P4EST_QMAXLEVEL + 1;
+    pe->data_size = e->data_size;
+
+    nslots = pe->num_peers * pe->num_levels + 1;
+    pe->send_offset = FCLAW_ALLOC (int, nslots);
+    pe->recv_offset = FCLAW_ALLOC (int, nslots);
+    pe->send_mirror = FCLAW_ALLOC (int, ghost->mirror_proc_offsets
+                                   [pe->num_peers]);
+    pe->recv_ghost = FCLAW_ALLOC (int, e->num_ghost_patches);
+
+    persistent_sort_by_level (&ghost->mirrors, pe->num_peers,
+                              pe->num_levels, ghost->mirror_proc_offsets,
+                              ghost->mirror_proc_mirrors,
+                              pe->send_offset, pe->send_mirror);
+    persistent_sort_by_level (&ghost->ghosts, pe->num_peers,
+                              pe->num_levels, ghost->proc_offsets, NULL,
+                              pe->recv_offset, pe->recv_ghost);
+
+    /* message buffers live until the next regrid */
+    pe->send_buffer = FCLAW_ALLOC (char, (size_t) pe->send_offset[nslots - 1]
+                                   * pe->data_size);
+    pe->recv_buffer = FCLAW_ALLOC (char, (size_t) pe->recv_offset[nslots - 1]
+                                   * pe->data_size);
+
+    sc_array_init (&pe->ranges, sizeof (persistent_range_t));
+    pe->active = NULL;
+
+    e->persistent = pe;
+#endif
+}
+
+void
+fclaw2d_domain_ghost_exchange_persistent_free (fclaw2d_domain_t * domain,
+                                               fclaw2d_domain_exchange_t * e)
+{
+#ifdef FCLAW_ENABLE_MPI
+    persistent_exchange_t *pe = (persistent_exchange_t *) e->persistent;
+    persistent_range_t *r;
+    size_t zz;
+    int i, mpiret;
+
+    if (pe == NULL)
+    {
+        return;
+    }
+    FCLAW_ASSERT (pe->active == NULL);
+
+    for (zz = 0; zz < pe->ranges.elem_count; ++zz)
+    {
+        r = (persistent_range_t *) sc_array_index (&pe->ranges, zz);
+        for (i = 0; i < r->num_requests; ++i)
+        {
+            mpiret = MPI_Request_free (&r->requests[i]);
+            SC_CHECK_MPI (mpiret);
+        }
+        FCLAW_FREE (r->requests);
+    }
+    sc_array_reset (&pe->ranges);
+
+    FCLAW_FREE (pe->send_offset);
+    FCLAW_FREE (pe->recv_offset);
+    FCLAW_FREE (pe->send_mirror);
+    FCLAW_FREE (pe->recv_ghost);
+    FCLAW_FREE (pe->send_buffer);
+    FCLAW_FREE (pe->recv_buffer);
+    FCLAW_FREE (pe);
+#endif
+    e->persistent = NULL;
+}
+
 void
 fclaw2d_domain_ghost_exchange (fclaw2d_domain_t * domain,
                                fclaw2d_domain_exchange_t * e,
@@ -1770,6 +2148,41 @@ fclaw2d_domain_ghost_exchange_begin (fclaw2d_domain_t * domain,
 
     FCLAW_ASSERT (e->num_exchange_patches == (int) ghost->mirrors.elem_count);
     FCLAW_ASSERT (e->num_ghost_patches == (int) ghost->ghosts.elem_count);
+#ifdef FCLAW_ENABLE_MPI
+    if (e->persistent != NULL &&
+        ((persistent_exchange_t *) e->persistent)->ghost == ghost)
+    {
+        persistent_exchange_t *pe = (persistent_exchange_t *) e->persistent;
+        int minlevel = SC_MAX (exchange_minlevel, 0);
+        int maxlevel = SC_MIN (exchange_maxlevel, pe->num_levels - 1);
+        int L = pe->num_levels;
+        int q, k, mpiret;
+
+        FCLAW_ASSERT (minlevel <= maxlevel);
+        pe->active = persistent_get_range (domain, pe, minlevel, maxlevel);
+
+        /* copy the patches to send into the message buffers */
+        for (q = 0; q < pe->num_peers; ++q)
+        {
+            for (k = pe->send_offset[q * L + minlevel];
+                 k < pe->send_offset[q * L + maxlevel + 1]; ++k)
+            {
+                memcpy (pe->send_buffer + k * pe->data_size,
+                        e->patch_data[pe->send_mirror[k]], pe->data_size);
+            }
+        }
+        if (pe->active->num_requests > 0)
+        {
+            mpiret = MPI_Startall (pe->active->num_requests,
+                                   pe->active->requests);
+            SC_CHECK_MPI (mpiret);
+        }
+        e->by_levels = 0;
+        e->async_state = pe;
+        e->inside_async = 1;
+        return;
+    }
+#endif
     if (exchange_minlevel <= domain->global_minlevel &&
         domain->global_maxlevel <= exchange_maxlevel)
     {
@@ -1799,6 +2212,39 @@ fclaw2d_domain_ghost_exchange_end (fclaw2d_domain_t * domain,
     FCLAW_ASSERT (exc != NULL);
     FCLAW_ASSERT (e->inside_async);
 
+#ifdef FCLAW_ENABLE_MPI
+    if (e->async_state == e->persistent)
+    {
+        persistent_exchange_t *pe = (persistent_exchange_t *) e->persistent;
+        persistent_range_t *r = pe->active;
+        int L = pe->num_levels;
+        int q, k, mpiret;
+
+        FCLAW_ASSERT (r != NULL);
+        if (r->num_requests > 0)
+        {
+            mpiret = sc_MPI_Waitall (r->num_requests, r->requests,
+                                     sc_MPI_STATUSES_IGNORE);
+            SC_CHECK_MPI (mpiret);
+        }
+
+        /* copy the received patches to their ghost data */
+        for (q = 0; q < pe->num_peers; ++q)
+        {
+            for (k = pe->recv_offset[q * L + r->minlevel];
+                 k < pe->recv_offset[q * L + r->maxlevel + 1]; ++k)
+            {
+                memcpy (e->ghost_data[pe->recv_ghost[k]],
+                        pe->recv_buffer + k * pe->data_size, pe->data_size);
+            }
+        }
+        pe->active = NULL;
+        e->async_state = NULL;
+        e->inside_async = 0;
+        return;
+    }
+#endif
+
     if (!e->by_levels)
     {
         p4est_ghost_exchange_custom_end (exc);
@@ -1816,6 +2262,7 @@ void
 fclaw2d_domain_free_after_exchange (fclaw2d_domain_t * domain,
                                     fclaw2d_domain_exchange_t * e)
 {
+    fclaw2d_domain_ghost_exchange_persistent_free (domain, e);
     FCLAW_FREE (e->ghost_contiguous_memory);
     FCLAW_FREE (e->ghost_data);
     FCLAW_FREE (e->patch_data);
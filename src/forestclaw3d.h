@@ -913,6 +913,66 @@ void fclaw3d_domain_iterate_partitioned (fclaw3d_domain_t * old_domain,
 void fclaw3d_domain_free_after_partition (fclaw3d_domain_t * domain,
                                           void ***patch_data);
 
+/** Opaque handle to the patch data received during partition. */
+typedef struct fclaw3d_domain_kept fclaw3d_domain_kept_t;
+
+/** Keep the patch data received during partition beyond
+ * \ref fclaw3d_domain_free_after_partition.
+ * Call after \ref fclaw3d_domain_retrieve_after_partition and before
+ * \ref fclaw3d_domain_free_after_partition.  The pointers in patch_data
+ * then stay valid until the last reference to the handle is released.
+ * The memory is held as one block, including the slots of patches that
+ * stayed local, and is freed as a whole.
+ * \param [in,out] domain       The memory lives inside this domain.
+ * \return                      Handle holding one reference.
+ */
+fclaw3d_domain_kept_t *fclaw3d_domain_keep_after_partition (fclaw3d_domain_t *
+                                                            domain);
+
+/** Add a reference to kept partition data.  Safe to call from threads.
+ * \param [in,out] kept         Handle from \ref fclaw3d_domain_keep_after_partition.
+ */
+void fclaw3d_domain_kept_ref (fclaw3d_domain_kept_t * kept);
+
+/** Release a reference to kept partition data.  Safe to call from threads.
+ * The memory is freed with the last reference.
+ * \param [in,out] kept         Handle from \ref fclaw3d_domain_keep_after_partition.
+ */
+void fclaw3d_domain_kept_unref (fclaw3d_domain_kept_t * kept);
+
+/** Save the partition of a domain for \ref fclaw3d_domain_transfer_after_partition.
+ * Call before \ref fclaw3d_domain_partition.
+ * \param [in] domain           The domain before partition.
+ * \return                      Global index of the first patch of each
+ *                              process, mpisize + 1 entries.
+ *                              Free with FCLAW_FREE.
+ */
+int64_t *fclaw3d_domain_save_partition (fclaw3d_domain_t * domain);
+
+/** Send patch data of varying size to the new owners after partition.
+ * An alternative to the fixed size transfer of \ref
+ * fclaw3d_domain_allocate_before_partition, for callers that send data
+ * of some patches only.  Sizes are sent first, then the data.
+ * This function is collective.
+ * \param [in] new_domain       Domain returned by \ref fclaw3d_domain_partition.
+ * \param [in] old_offsets      Saved by \ref fclaw3d_domain_save_partition.
+ * \param [in] src_data         Data of the local patches before partition,
+ *                              contiguous in patch order.
+ * \param [in] src_sizes        Bytes for each local patch before partition.
+ *                              Zero for patches without data.
+ * \param [out] dest_data       Data of the local patches after partition,
+ *                              contiguous in patch order.  Free with FCLAW_FREE.
+ * \param [out] dest_sizes      Bytes for each local patch after partition.
+ *                              Zero for patches that were sent without
+ *                              data.  Free with FCLAW_FREE.
+ */
+void fclaw3d_domain_transfer_after_partition (fclaw3d_domain_t * new_domain,
+                                              const int64_t * old_offsets,
+                                              const void *src_data,
+                                              const int *src_sizes,
+                                              void **dest_data,
+                                              int **dest_sizes);
+
 ///@}
 /* ---------------------------------------------------------------------- */
 ///                         @name Exchange
@@ -953,6 +1013,11 @@ typedef struct fclaw3d_domain_exchange
     void *async_state;
     int inside_async;           /**< Between asynchronous begin and end? */
     int by_levels;              /**< Did we use levels on the inside? */
+
+    /** Persistent requests and message buffers, or NULL.
+     * See fclaw3d_domain_ghost_exchange_persistent_setup.
+     */
+    void *persistent;
 }
 fclaw3d_domain_exchange_t;
 
@@ -1018,6 +1083,33 @@ void fclaw3d_domain_ghost_exchange_end (fclaw3d_domain_t * domain,
 void fclaw3d_domain_free_after_exchange (fclaw3d_domain_t * domain,
                                          fclaw3d_domain_exchange_t * e);
 
+/** Create persistent communication requests for the ghost exchange.
+ * The exchange pattern does not change between two regrids, so the
+ * point-to-point requests and the message buffers can be set up once.
+ * Requests for a given range of exchanged levels are created on first use.
+ * Afterwards, fclaw3d_domain_ghost_exchange_begin and _end start and
+ * complete these requests instead of posting new messages.
+ * Without MPI or on a single process, this function does nothing.
+ * \param [in] domain           The domain is not modified.
+ * \param [in,out] e            Allocated buffers.  Its ghost_data must not
+ *                              be reallocated until the requests are freed.
+ */
+void fclaw3d_domain_ghost_exchange_persistent_setup (fclaw3d_domain_t *
+                                                     domain,
+                                                     fclaw3d_domain_exchange_t
+                                                     * e);
+
+/** Free the persistent requests and buffers created by
+ * fclaw3d_domain_ghost_exchange_persistent_setup.
+ * Must not be called between ghost exchange begin and end.
+ * Safe to call if no persistent requests exist.
+ * \param [in] domain           The domain is not modified.
+ * \param [in,out] e            Allocated buffers.
+ */
+void fclaw3d_domain_ghost_exchange_persistent_free (fclaw3d_domain_t * domain,
+                                                    fclaw3d_domain_exchange_t *
+                                                    e);
+
 ///@}
 /* ---------------------------------------------------------------------- */
 ///                 @name Indirect Parallel Neighbors
@@ -1126,6 +1218,33 @@ void fclaw3d_domain_indirect_destroy (fclaw3d_domain_t * domain,
  */
 double fclaw3d_domain_global_maximum (fclaw3d_domain_t * domain, double d);
 
+/** State of a non-blocking global maximum. */
+typedef struct fclaw3d_domain_reduce
+{
+    double local;               /**< Contribution of this processor */
+    double global;              /**< Global maximum after _end */
+    sc_MPI_Request request;     /**< Reduction in progress */
+    int inside_async;           /**< Between begin and end? */
+}
+fclaw3d_domain_reduce_t;
+
+/** Start a non-blocking maximum over all processors of a double value.
+ * It must be followed by a call to fclaw3d_domain_global_maximum_end.
+ * \param [in] domain           The domain is not modified.
+ * \param [in] d                Local value.
+ * \param [out] r               Must survive until the matching _end.
+ */
+void fclaw3d_domain_global_maximum_begin (fclaw3d_domain_t * domain,
+                                          double d,
+                                          fclaw3d_domain_reduce_t * r);
+
+/** Complete a non-blocking maximum and return the result.
+ * \param [in] domain           The domain is not modified.
+ * \param [in,out] r            Started by _begin.
+ */
+double fclaw3d_domain_global_maximum_end (fclaw3d_domain_t * domain,
+                                          fclaw3d_domain_reduce_t * r);
+
 /** Compute and return the sum over all processors of a double value.
  */
 double fclaw3d_domain_global_sum (fclaw3d_domain_t * domain, double d);
@@ -85,6 +85,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <fclaw2d_defs.h>
 #include <fclaw2d_global.h>
+#include <fclaw2d_domain.h>
 #include <fclaw2d_vtable.h>
 #include <fclaw2d_options.h>
 
@@ -95,6 +96,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <fclaw_pointer_map.h>
 
+#include <sc_statistics.h>
+
+#include <math.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
 
 
 /* ------------------------------- Static function defs ------------------------------- */
@@ -142,6 +150,19 @@ fclaw2d_metric_patch_t* get_metric_patch(fclaw2d_patch_t *patch)
 	return (fclaw2d_metric_patch_t*) clawpatch_get_metric_patch(patch);
 }
 
+/* Optional fields (time interpolated data, error fields) are allocated
+   the first time they are needed, with the layout of griddata.  Only the
+   thread updating the patch may call this. */
+static
+FArrayBox& optional_field(fclaw2d_clawpatch_t *cp, FArrayBox& fbox, int fields)
+{
+	if (fbox.size() == 0)
+	{
+		fbox.define(cp->griddata.box(), fields);
+	}
+	return fbox;
+}
+
 /* Return a pointer to either time interpolated data or regular grid data */
 static 
 double* q_time_sync(fclaw2d_patch_t* patch, int time_interp)
@@ -167,6 +188,13 @@ static
 void* clawpatch_new()
 {
 	fclaw2d_clawpatch_t *cp = new fclaw2d_clawpatch_t;    
+	cp->save_pending = 0;
+	cp->griddata_adopted = 0;
+	cp->tag_refine.valid = 0;
+	cp->tag_refine.fresh = 0;
+	cp->tag_coarsen.valid = 0;
+	cp->tag_coarsen.fresh = 0;
+	cp->step_change_counted = 1;  /* No step taken yet */
 
 	/* This patch will only be defined if we are on a manifold. */
 	cp->mp = fclaw2d_metric_patch_new();
@@ -318,14 +346,9 @@ void clawpatch_define(fclaw2d_global_t* glob,
 
 	// This will destroy any existing memory n griddata.
 	cp->griddata.define(box, cp->meqn);
-	if (fclaw_opt->subcycle)
-		cp->griddata_time_interpolated.define(box, cp->meqn);
 
-	if (fclaw_opt->compute_error)
-	{
-		cp->griderror.define(box,cp->meqn);
-		cp->exactsolution.define(box,cp->meqn);
-	}
+	/* Time interpolated data and error fields are allocated on first use;
+	   the finest level is never time interpolated. */
 
 	if (clawpatch_opt->maux > 0)
 	{		
@@ -337,11 +360,6 @@ void clawpatch_define(fclaw2d_global_t* glob,
 	if (clawpatch_opt->rhs_fields > 0)
 	{
 		cp->rhs.define(box,cp->mfields);
-		if (fclaw_opt->compute_error)
-		{
-			cp->elliptic_error.define(box,cp->mfields);
-			cp->elliptic_soln.define(box,cp->mfields);
-		}
 	}
 
 	if (fclaw_opt->manifold)
@@ -377,9 +395,13 @@ void clawpatch_define(fclaw2d_global_t* glob,
 		/* If we are building ghost patches, we don't need all the patch memory */
 		return;
 
-	cp->griddata_last.define(box, cp->meqn);
+	/* The saved step is kept in double precision, since restoring it has to
+	   give back the solution exactly */
+	if (clawpatch_opt->reduced_precision)
+		cp->griddata_last_float.resize(cp->griddata.size());
+	else
+		cp->griddata_last.define(box, cp->meqn);
 	cp->griddata_save.define(box, cp->meqn);
-
 }
 
 static
@@ -442,18 +464,133 @@ void clawpatch_build_from_fine(fclaw2d_global_t *glob,
 
 /* -------------------------------- time stepping ------------------------------------- */
 
+/* Single precision copy of the last step (option reduced_precision) */
 static
-void clawpatch_save_step(fclaw2d_global_t* glob,
-						 fclaw2d_patch_t* patch)
+void copy_to_float(std::vector<float>& dest, FArrayBox& src)
 {
-	fclaw2d_clawpatch_t *cp = get_clawpatch(patch);
+	const double *q = src.dataPtr();
+	int size = src.size();
+	FCLAW_ASSERT((int) dest.size() == size);
+	for (int i = 0; i < size; i++)
+	{
+		dest[i] = (float) q[i];
+	}
+}
+
+static
+void copy_from_float(double *dest, const std::vector<float>& src)
+{
+	int size = (int) src.size();
+	for (int i = 0; i < size; i++)
+	{
+		dest[i] = src[i];
+	}
+}
+
+/* Largest change of the solution in the last step, i.e. max |q - qlast|.
+   With update set, q is copied to the last step in the same pass. */
+static
+double clawpatch_step_change(fclaw2d_global_t *glob,
+							 fclaw2d_clawpatch_t *cp, int update)
+{
+	const fclaw2d_clawpatch_options_t *clawpatch_opt = fclaw2d_clawpatch_get_options(glob);
+	const double *q = cp->griddata.dataPtr();
+	int size = cp->griddata.size();
+	double change = 0;
+	if (clawpatch_opt->reduced_precision)
+	{
+		float *qlast = cp->griddata_last_float.data();
+		FCLAW_ASSERT((int) cp->griddata_last_float.size() == size);
+		for (int i = 0; i < size; i++)
+		{
+			double d = fabs(q[i] - qlast[i]);
+			change = d > change ? d : change;
+			if (update)
+				qlast[i] = (float) q[i];
+		}
+	}
+	else
+	{
+		double *qlast = cp->griddata_last.dataPtr();
+		FCLAW_ASSERT(cp->griddata_last.size() == size);
+		for (int i = 0; i < size; i++)
+		{
+			double d = fabs(q[i] - qlast[i]);
+			change = d > change ? d : change;
+			if (update)
+				qlast[i] = q[i];
+		}
+	}
+	return change;
+}
+
+/* Add the change of the last step to the bounds of both regrid tags */
+static
+void clawpatch_count_step_change(fclaw2d_global_t *glob,
+								 fclaw2d_clawpatch_t *cp, int update)
+{
+	double change = clawpatch_step_change(glob,cp,update);
+	cp->tag_refine.change += change;
+	cp->tag_refine.steps++;
+	cp->tag_coarsen.change += change;
+	cp->tag_coarsen.steps++;
+	cp->step_change_counted = 1;
+}
+
+/* Saving a step only marks it as saved.  The copy is made when the patch is
+   about to be updated (see clawpatch_begin_update), before b4step2 or the
+   solver write to it, and skipped entirely if the patch is not updated
+   before the step is saved again or restored. */
+static
+void clawpatch_commit_saved_step(fclaw2d_global_t* glob,
+								 fclaw2d_clawpatch_t *cp)
+{
+	const fclaw2d_clawpatch_options_t *clawpatch_opt = fclaw2d_clawpatch_get_options(glob);
 	cp->griddata_save = cp->griddata;
 
 	/* Some aux arrays are time dependent, or contain part of the solution.  In this case, 
 	   we should save the aux array in case we need to re-take a time step */
-	const fclaw2d_clawpatch_options_t *clawpatch_opt = fclaw2d_clawpatch_get_options(glob);
 	if (clawpatch_opt->save_aux)
 		cp->aux_save = cp->aux;
+
+	cp->save_pending = 0;
+}
+
+static
+void clawpatch_save_step(fclaw2d_global_t* glob,
+						 fclaw2d_patch_t* patch)
+{
+	fclaw2d_clawpatch_t *cp = get_clawpatch(patch);
+	cp->save_pending = 1;
+}
+
+/* Copy adopted partition data into storage of the patch's own, so that a
+   patch that lives on does not hold the receive buffer of every patch
+   that came with it.  The buffer is freed with its last view. */
+static
+void clawpatch_release_adopted(fclaw2d_clawpatch_t *cp)
+{
+	FArrayBox owned;
+	owned.define(cp->griddata.box(),cp->griddata.fields());
+	memcpy(owned.dataPtr(),cp->griddata.dataPtr(),
+	       cp->griddata.size()*sizeof(double));
+	cp->griddata.swap(owned);
+	cp->griddata_adopted = 0;
+}
+
+static
+void clawpatch_begin_update(fclaw2d_global_t* glob,
+							fclaw2d_patch_t* patch)
+{
+	fclaw2d_clawpatch_t *cp = get_clawpatch(patch);
+	if (cp->griddata_adopted)
+	{
+		clawpatch_release_adopted(cp);
+	}
+	if (cp->save_pending)
+	{
+		clawpatch_commit_saved_step(glob,cp);
+	}
 }
 
 
@@ -462,12 +599,18 @@ void clawpatch_restore_step(fclaw2d_global_t* glob,
 							fclaw2d_patch_t* patch)
 {
 	fclaw2d_clawpatch_t *cp = get_clawpatch(patch);
-	cp->griddata = cp->griddata_save;
+	if (cp->save_pending)
+	{
+		/* Patch has not been modified since the step was saved */
+		cp->save_pending = 0;
+		return;
+	}
+	const fclaw2d_clawpatch_options_t *clawpatch_opt = fclaw2d_clawpatch_get_options(glob);
+	cp->griddata.swap(cp->griddata_save);
 
 	/* Restore the aux array after before retaking a time step */
-	const fclaw2d_clawpatch_options_t *clawpatch_opt = fclaw2d_clawpatch_get_options(glob);
 	if (clawpatch_opt->save_aux)
-		cp->aux = cp->aux_save;
+		cp->aux.swap(cp->aux_save);
 }
 
 static
@@ -503,8 +646,15 @@ void clawpatch_setup_timeinterp(fclaw2d_global_t *glob,
 	   exchanges */
 	fclaw2d_clawpatch_t *cp = get_clawpatch(patch);
 	double *qlast = cp->griddata_last.dataPtr();
+	if (clawpatch_opt->reduced_precision)
+	{
+		/* Widen the last step into scratch space for the kernel */
+		qlast = fclaw2d_global_get_scratch(glob, 0, cp->griddata_last_float.size());
+		copy_from_float(qlast, cp->griddata_last_float);
+	}
 	double *qcurr = cp->griddata.dataPtr();
-	double *qinterp = cp->griddata_time_interpolated.dataPtr();
+	double *qinterp = optional_field(cp,cp->griddata_time_interpolated,
+	                                 cp->meqn).dataPtr();
 
 	int ierror;
 
@@ -796,16 +946,83 @@ void clawpatch_interpolate_corner(fclaw2d_global_t* glob,
 
 /* -------------------------------- Regridding functions ------------------------------ */
 
+/* A tag is reused if the solution has changed by less than tol since it
+   was computed.  Steps are required, since solvers that do not save the
+   last step (see fclaw2d_clawpatch_save_current_step) are not tracked. */
 static
-int clawpatch_tag4refinement(fclaw2d_global_t *glob,
-							 fclaw2d_patch_t *patch,
-							 int blockno, int patchno,
-							 int initflag)
+int tag_cache_reusable(fclaw2d_global_t *glob,
+					   fclaw2d_clawpatch_t *cp,
+					   const fclaw2d_clawpatch_t::tag_cache& tc)
 {
+	const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+	if (!cp->step_change_counted)
+	{
+		/* Last step taken, but not yet counted */
+		clawpatch_count_step_change(glob,cp,0);
+	}
+	return tc.valid && tc.steps > 0 && tc.change < fclaw_opt->tag_reuse_tolerance;
+}
+
+static
+void tag_cache_store(fclaw2d_clawpatch_t::tag_cache& tc, int tag)
+{
+	tc.valid = 1;
+	tc.fresh = 0;
+	tc.tag = tag;
+	tc.steps = 0;
+	tc.change = 0;
+}
+
+/* Run the refinement criteria over the patch.  The criteria may call back
+   into C through the global context, which is not thread safe. */
+static
+int clawpatch_tag4refinement_compute(fclaw2d_global_t *glob,
+									 fclaw2d_patch_t *patch,
+									 int blockno,
+									 int initflag)
+{
+	const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+	double refine_threshold = fclaw_opt->refine_threshold;
+
 	int meqn;
 	double *q;
 	fclaw2d_clawpatch_soln_data(glob,patch,&q,&meqn);
 
+	/* This allows the user to specify a "exceeds_th" */
+	fclaw2d_clawpatch_vtable_t* clawpatch_vt = fclaw2d_clawpatch_vt(glob);
+
+	/* The caller sets the global glob read by the Fortran criteria */
+	int tag_patch = 0;
+	int mx,my,mbc;
+	double xlower,ylower,dx,dy;
+#if PATCH_DIM == 2
+	fclaw2d_clawpatch_grid_data(glob,patch,&mx,&my,&mbc,
+	                            &xlower,&ylower,&dx,&dy);
+	clawpatch_vt->fort_tag4refinement(&mx,&my,&mbc,&meqn,&xlower,&ylower,
+	                                  &dx,&dy, &blockno, q,
+	                                  &refine_threshold,
+	                                  &initflag,&tag_patch);
+#elif PATCH_DIM == 3
+	int mz;
+	double zlower,dz;
+	fclaw3dx_clawpatch_grid_data(glob,patch,&mx,&my,&mz, &mbc,
+	                            &xlower,&ylower,&zlower, &dx,&dy,&dz);
+
+	clawpatch_vt->fort_tag4refinement(&mx,&my,&mz, &mbc,&meqn,
+	                                  &xlower,&ylower,&zlower,
+	                                  &dx,&dy, &dz, &blockno, q,
+	                                  &refine_threshold,
+	                                  &initflag,&tag_patch);
+#endif		
+	return tag_patch;
+}
+
+static
+int clawpatch_tag4refinement(fclaw2d_global_t *glob,
+							 fclaw2d_patch_t *patch,
+							 int blockno, int patchno,
+							 int initflag)
+{
 	const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
 	double refine_threshold = fclaw_opt->refine_threshold;
 
@@ -817,34 +1034,22 @@ int clawpatch_tag4refinement(fclaw2d_global_t *glob,
 	}
 	else
 	{
-		tag_patch = 0;	
-
-		/* This allows the user to specify a "exceeds_th" */
-		fclaw2d_clawpatch_vtable_t* clawpatch_vt = fclaw2d_clawpatch_vt(glob);
+		fclaw2d_clawpatch_t *cp = get_clawpatch(patch);
+		if (!initflag && cp->tag_refine.fresh)
+		{
+			/* Tagged in the update that produced the current solution */
+			return cp->tag_refine.tag;
+		}
+		if (fclaw_opt->tag_reuse_tolerance > 0 && !initflag && 
+		    tag_cache_reusable(glob,cp,cp->tag_refine))
+		{
+			return cp->tag_refine.tag;
+		}
 
-		int mx,my,mbc;
-		double xlower,ylower,dx,dy;
 		fclaw2d_global_set_global(glob);
-#if PATCH_DIM == 2
-		fclaw2d_clawpatch_grid_data(glob,patch,&mx,&my,&mbc,
-		                            &xlower,&ylower,&dx,&dy);
-		clawpatch_vt->fort_tag4refinement(&mx,&my,&mbc,&meqn,&xlower,&ylower,
-		                                  &dx,&dy, &blockno, q,
-		                                  &refine_threshold,
-		                                  &initflag,&tag_patch);
-#elif PATCH_DIM == 3
-		int mz;
-		double zlower,dz;
-		fclaw3dx_clawpatch_grid_data(glob,patch,&mx,&my,&mz, &mbc,
-		                            &xlower,&ylower,&zlower, &dx,&dy,&dz);
-
-		clawpatch_vt->fort_tag4refinement(&mx,&my,&mz, &mbc,&meqn,
-		                                  &xlower,&ylower,&zlower,
-		                                  &dx,&dy, &dz, &blockno, q,
-		                                  &refine_threshold,
-		                                  &initflag,&tag_patch);
-#endif		
+		tag_patch = clawpatch_tag4refinement_compute(glob,patch,blockno,initflag);
 		fclaw2d_global_unset_global();
+		tag_cache_store(cp->tag_refine,tag_patch);
 	}
 	return tag_patch;
 }
@@ -869,6 +1074,27 @@ int clawpatch_tag4coarsening(fclaw2d_global_t *glob,
 	double zlower, dz;
 #endif
 
+	const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+	double coarsen_threshold = fclaw_opt->coarsen_threshold;
+
+	/* The family decision is kept on all four siblings */
+	fclaw2d_clawpatch_t *cp[4];
+	int reuse = fclaw_opt->tag_reuse_tolerance > 0 && !initflag && 
+	            coarsen_threshold > 0;
+	for (int igrid = 0; igrid < 4; igrid++)
+	{
+		cp[igrid] = get_clawpatch(&fine_patches[igrid]);
+		if (reuse)
+		{
+			reuse = tag_cache_reusable(glob,cp[igrid],cp[igrid]->tag_coarsen) &&
+			        cp[igrid]->tag_coarsen.tag == cp[0]->tag_coarsen.tag;
+		}
+	}
+	if (reuse)
+	{
+		return cp[0]->tag_coarsen.tag;
+	}
+
 	double *q[4];  /* Only need four grids, even for extruded mesh case */
 	for (int igrid = 0; igrid < 4; igrid++)
 	{
@@ -883,9 +1109,6 @@ int clawpatch_tag4coarsening(fclaw2d_global_t *glob,
 #endif
 	}
 
-	const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
-	double coarsen_threshold = fclaw_opt->coarsen_threshold;
-
 	int tag_patch = 0;
 	if (coarsen_threshold > 0) 
 	{		
@@ -905,6 +1128,10 @@ int clawpatch_tag4coarsening(fclaw2d_global_t *glob,
 		                                  &coarsen_threshold,&initflag,&tag_patch);
 #endif
 		fclaw2d_global_unset_global();
+		for (int igrid = 0; igrid < 4; igrid++)
+		{
+			tag_cache_store(cp[igrid]->tag_coarsen,tag_patch == 1);
+		}
 	}
 	else
 	{
@@ -1015,6 +1242,53 @@ void clawpatch_average2coarse(fclaw2d_global_t *glob,
 
 /* ------------------------------ Parallel ghost patches ------------------------------ */
 
+/* Number of doubles used for the conservation registers */
+static
+size_t clawpatch_ghost_register_elems(fclaw2d_global_t* glob)
+{
+	const fclaw2d_clawpatch_options_t *clawpatch_opt = 
+					     	fclaw2d_clawpatch_get_options(glob);
+	const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+	int meqn = clawpatch_opt->meqn;
+
+	return fclaw_opt->time_sync ? 
+	       2*(4*meqn+2)*(clawpatch_opt->mx + clawpatch_opt->my) : 0;
+}
+
+/* With ghost_pack_float, strips (q, area, extra fields) are sent as floats,
+   padded so that the double precision registers that follow are aligned. */
+static
+size_t ghost_float_bytes(size_t nfloat)
+{
+	return (nfloat*sizeof(float) + sizeof(double) - 1)/sizeof(double)*sizeof(double);
+}
+
+static
+void ghost_wire_encode(const double *qpack, void *wire, 
+                       size_t nfloat, size_t nregisters)
+{
+	float *fwire = (float*) wire;
+	for (size_t i = 0; i < nfloat; i++)
+	{
+		fwire[i] = (float) qpack[i];
+	}
+	char *rwire = (char*) wire + ghost_float_bytes(nfloat);
+	memcpy(rwire, qpack + nfloat, nregisters*sizeof(double));
+}
+
+static
+void ghost_wire_decode(const void *wire, double *qpack, 
+                       size_t nfloat, size_t nregisters)
+{
+	const float *fwire = (const float*) wire;
+	for (size_t i = 0; i < nfloat; i++)
+	{
+		qpack[i] = fwire[i];
+	}
+	const char *rwire = (const char*) wire + ghost_float_bytes(nfloat);
+	memcpy(qpack + nfloat, rwire, nregisters*sizeof(double));
+}
+
 /* This is called just to get a count of how much to pack */
 static
 size_t clawpatch_ghost_pack_elems(fclaw2d_global_t* glob)
@@ -1040,7 +1314,7 @@ size_t clawpatch_ghost_pack_elems(fclaw2d_global_t* glob)
 	   even though only one or two sides may be used. */
 	// int frsize = 12*meqn*(mx + my); 
 
-	int frsize = packregisters ? 2*(4*meqn+2)*(mx + my) : 0;
+	int frsize = clawpatch_ghost_register_elems(glob);
 #if PATCH_DIM == 3
 	int mz = clawpatch_opt->mz;
 	if (packregisters)
@@ -1100,7 +1374,7 @@ void clawpatch_ghost_comm(fclaw2d_global_t* glob,
 	   (Time sync not yet implemented in 3d, though). 
 
 	   */
-	int frsize = packregisters ? 2*(4*meqn+2)*(mx + my) : 0;
+	int frsize = clawpatch_ghost_register_elems(glob);
 
 #if PATCH_DIM == 3
 	int mz = clawpatch_opt->mz;
@@ -1138,6 +1412,19 @@ void clawpatch_ghost_comm(fclaw2d_global_t* glob,
 	double *qthis;
 	fclaw2d_clawpatch_timesync_data(glob,patch,time_interp,&qthis,&meqn);
 	double *qpack = (double*) unpack_from_here;
+
+	/* Single precision strips are widened/narrowed through scratch space */
+	int unpack = packmode % 2;
+	size_t nfloat = psize - frsize;
+	double *qwork = qpack;
+	if (clawpatch_opt->ghost_pack_float)
+	{
+		qwork = qpack = fclaw2d_global_get_scratch(glob, 0, psize);
+		if (unpack)
+		{
+			ghost_wire_decode(unpack_from_here, qwork, nfloat, frsize);
+		}
+	}
 #if PATCH_DIM == 2
 	int qareasize = (wg - hole)*(meqn + packarea);
 	double *area = clawpatch_get_area(glob, patch);	
@@ -1183,6 +1470,10 @@ void clawpatch_ghost_comm(fclaw2d_global_t* glob,
 		FCLAW_ASSERT(ierror == 0);
 	}
 
+	if (clawpatch_opt->ghost_pack_float && !unpack)
+	{
+		ghost_wire_encode(qwork, unpack_from_here, nfloat, frsize);
+	}
 
 	if (ierror > 0)
 	{
@@ -1194,7 +1485,14 @@ void clawpatch_ghost_comm(fclaw2d_global_t* glob,
 
 static size_t clawpatch_ghost_packsize(fclaw2d_global_t* glob)
 {
+	const fclaw2d_clawpatch_options_t *clawpatch_opt = 
+	                        fclaw2d_clawpatch_get_options(glob);
 	size_t esize = clawpatch_ghost_pack_elems(glob);
+	if (clawpatch_opt->ghost_pack_float)
+	{
+		size_t frsize = clawpatch_ghost_register_elems(glob);
+		return ghost_float_bytes(esize - frsize) + frsize*sizeof(double);
+	}
 	return esize*sizeof(double);
 }
 
@@ -1208,6 +1506,13 @@ void clawpatch_local_ghost_pack(fclaw2d_global_t *glob,
 	int packarea = fclaw_opt->ghost_patch_pack_area && fclaw_opt->manifold;
 	int packmode = 2*packarea;  // 0 or 2  (for pack)
 
+	if (time_interp)
+	{
+		/* Every mirror on the time interpolated level is packed, also those
+		   without fine neighbors, which have not set up this field */
+		fclaw2d_clawpatch_t *cp = get_clawpatch(patch);
+		optional_field(cp,cp->griddata_time_interpolated,cp->meqn);
+	}
 	clawpatch_ghost_comm(glob,patch,patch_data, time_interp,packmode);
 }
 
@@ -1222,7 +1527,16 @@ void clawpatch_remote_ghost_unpack(fclaw2d_global_t* glob,
 	int packarea = fclaw_opt->ghost_patch_pack_area && fclaw_opt->manifold;
 	int packmode = 2*packarea + 1;  // 1 or 3  (for unpack)
 
+	if (time_interp)
+	{
+		fclaw2d_clawpatch_t *cp = get_clawpatch(patch);
+		optional_field(cp,cp->griddata_time_interpolated,cp->meqn);
+	}
 	clawpatch_ghost_comm(glob,patch,qdata,time_interp,packmode);
+
+	glob->count_wire_bytes_saved += 
+	        clawpatch_ghost_pack_elems(glob)*sizeof(double) - 
+	        clawpatch_ghost_packsize(glob);
 }
 
 static
@@ -1263,13 +1577,13 @@ void clawpatch_remote_ghost_delete(void *patchcp)
 /* ---------------------------- Parallel partitioning --------------------------------- */
 
 static
-size_t clawpatch_partition_packsize(fclaw2d_global_t* glob)
+size_t clawpatch_partition_elems(fclaw2d_global_t* glob, int interior)
 {
 	const fclaw2d_clawpatch_options_t *clawpatch_opt 
 							  = fclaw2d_clawpatch_get_options(glob);
 	int mx = clawpatch_opt->mx;
 	int my = clawpatch_opt->my;
-	int mbc = clawpatch_opt->mbc;
+	int mbc = interior ? 0 : clawpatch_opt->mbc;
 	int meqn = clawpatch_opt->meqn;
 	size_t psize = meqn*(2*mbc + mx)*(2*mbc + my);  /* Store area */
 
@@ -1278,7 +1592,65 @@ size_t clawpatch_partition_packsize(fclaw2d_global_t* glob)
 	psize *= (2*mbc + mz);
 #endif
 
-	return psize*sizeof(double);
+	return psize;
+}
+
+/* Coarse patches sent for refinement on the new owner need their ghost
+   cells to interpolate, so refine-on-destination sends whole patches.
+   Initial refinement tags partitioned patches before any ghost update
+   unless init_ghostcell is set, so without it whole patches are sent too. */
+static
+int clawpatch_partition_interior(fclaw2d_global_t* glob)
+{
+	const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+	const fclaw2d_clawpatch_options_t *clawpatch_opt 
+							  = fclaw2d_clawpatch_get_options(glob);
+	return clawpatch_opt->partition_pack_interior && 
+	       fclaw_opt->init_ghostcell &&
+	       !fclaw_opt->refine_on_destination;
+}
+
+static
+size_t clawpatch_partition_packsize(fclaw2d_global_t* glob)
+{
+	int interior = clawpatch_partition_interior(glob);
+	return clawpatch_partition_elems(glob,interior)*sizeof(double);
+}
+
+/* Copy interior cells of griddata to (pack) or from (unpack) a buffer */
+static
+void clawpatch_partition_copy_interior(fclaw2d_clawpatch_t *cp,
+                                       double *buffer, int unpack)
+{
+	int mbc = cp->mbc;
+	int nx = cp->mx + 2*mbc;
+	int ny = cp->my + 2*mbc;
+#if PATCH_DIM == 2
+	int nz = 1;
+	int kbc = 0;
+	int mz = 1;
+#else
+	int nz = cp->mz + 2*mbc;
+	int kbc = mbc;
+	int mz = cp->mz;
+#endif
+	size_t row = cp->mx*sizeof(double);
+	double *q = cp->griddata.dataPtr();
+	for (int m = 0; m < cp->meqn; m++)
+	{
+		for (int k = kbc; k < kbc + mz; k++)
+		{
+			for (int j = mbc; j < mbc + cp->my; j++)
+			{
+				double *qrow = q + mbc + nx*(j + ny*(k + nz*m));
+				if (unpack)
+					memcpy(qrow, buffer, row);
+				else
+					memcpy(buffer, qrow, row);
+				buffer += cp->mx;
+			}
+		}
+	}
 }
 
 static
@@ -1291,7 +1663,10 @@ void clawpatch_partition_pack(fclaw2d_global_t *glob,
 	fclaw2d_clawpatch_t *cp = get_clawpatch(patch);
 	FCLAW_ASSERT(cp != NULL);
 
-	cp->griddata.copyToMemory((double*) pack_data_here);
+	if (clawpatch_partition_interior(glob))
+		clawpatch_partition_copy_interior(cp,(double*) pack_data_here,0);
+	else
+		cp->griddata.copyToMemory((double*) pack_data_here);
 }
 
 static
@@ -1308,7 +1683,262 @@ void clawpatch_partition_unpack(fclaw2d_global_t *glob,
 	   are time synchronized and all flux registers are set to 
 	   zero.  After copying data, we re-build patch with any 
 	   data needed.  */
-	cp->griddata.copyFromMemory((double*)unpack_data_from_here);
+	const fclaw2d_clawpatch_options_t *clawpatch_opt 
+							  = fclaw2d_clawpatch_get_options(glob);
+	if (clawpatch_partition_interior(glob))
+	{
+		/* Ghost cells are set by the ghost update that follows partitioning */
+		memset(cp->griddata.dataPtr(), 0, cp->griddata.size()*sizeof(double));
+		clawpatch_partition_copy_interior(cp,(double*)unpack_data_from_here,1);
+#pragma omp atomic
+		glob->count_wire_bytes_saved += 
+		        (clawpatch_partition_elems(glob,0) - 
+		         clawpatch_partition_elems(glob,1))*sizeof(double);
+	}
+	else if (clawpatch_opt->partition_adopt && 
+	         fclaw2d_domain_get_data(new_domain)->partition_kept != NULL)
+	{
+		/* Use the received data in place until the patch is next updated.
+		   The partition memory is freed once the last patch viewing it is
+		   updated, deleted or repacked. */
+		fclaw2d_domain_kept_t *kept = 
+		        fclaw2d_domain_get_data(new_domain)->partition_kept;
+		double *q = (double*) unpack_data_from_here;
+		fclaw2d_domain_kept_ref(kept);
+		std::shared_ptr<double> storage(q, [kept](double*)
+		                                {
+		                                    fclaw2d_domain_kept_unref(kept);
+		                                });
+		cp->griddata.define_view(cp->griddata.box(),cp->griddata.fields(),
+		                         storage,q);
+		cp->griddata_adopted = 1;
+	}
+	else
+	{
+		cp->griddata.copyFromMemory((double*)unpack_data_from_here);
+	}
+}
+
+/* ------------------------------- Level-wide storage --------------------------------- */
+
+/* Move one field of all patches in a level into a single array, patch by
+   patch in local (Morton) order.  Each slot is padded to a cache line.
+   The copy doubles as first touch, with the same static schedule used by
+   the threaded level iterators. */
+static
+void clawpatch_pack_level_field(std::vector<fclaw2d_clawpatch_t*>& level,
+								FArrayBox fclaw2d_clawpatch_t::*field)
+{
+	int count = (int) level.size();
+	int size = (level[0]->*field).size();
+	for (int i = 0; i < count; i++)
+	{
+		if ((level[i]->*field).size() != size || size == 0)
+		{
+			/* Field not in use, or not yet allocated on all patches */
+			return;
+		}
+	}
+
+	size_t stride = ((size_t) size + 7)/8*8;
+	std::shared_ptr<double> storage = 
+			fclaw2d_farraybox_storage_new(stride*count);
+
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < count; i++)
+	{
+		FArrayBox& fbox = level[i]->*field;
+		double *slot = storage.get() + stride*i;
+		memcpy(slot, fbox.dataPtr(), size*sizeof(double));
+		fbox.define_view(fbox.box(), fbox.fields(), storage, slot);
+		if (field == &fclaw2d_clawpatch_t::griddata)
+		{
+			level[i]->griddata_adopted = 0;
+		}
+	}
+}
+
+static
+void clawpatch_pack_levels(fclaw2d_global_t *glob)
+{
+	const fclaw2d_clawpatch_options_t *clawpatch_opt 
+							  = fclaw2d_clawpatch_get_options(glob);
+	if (!clawpatch_opt->level_storage)
+	{
+		return;
+	}
+
+	fclaw2d_domain_t *domain = glob->domain;
+	std::vector<std::vector<fclaw2d_clawpatch_t*> > levels;
+	for (int nb = 0; nb < domain->num_blocks; nb++)
+	{
+		fclaw2d_block_t *block = &domain->blocks[nb];
+		for (int np = 0; np < block->num_patches; np++)
+		{
+			fclaw2d_patch_t *patch = &block->patches[np];
+			if (patch->level >= (int) levels.size())
+			{
+				levels.resize(patch->level + 1);
+			}
+			levels[patch->level].push_back(get_clawpatch(patch));
+		}
+	}
+
+	/* Old level arrays are released once their last patch has moved */
+	for (size_t level = 0; level < levels.size(); level++)
+	{
+		if (levels[level].empty())
+		{
+			continue;
+		}
+		clawpatch_pack_level_field(levels[level], &fclaw2d_clawpatch_t::griddata);
+		clawpatch_pack_level_field(levels[level], &fclaw2d_clawpatch_t::griddata_last);
+		clawpatch_pack_level_field(levels[level], &fclaw2d_clawpatch_t::griddata_save);
+		clawpatch_pack_level_field(levels[level], &fclaw2d_clawpatch_t::aux);
+	}
+}
+
+/* ------------------------------- Release memory ----------------------------------- */
+
+/* Drop an optional field; optional_field allocates it again if needed */
+static
+void release_optional_field(FArrayBox& fbox)
+{
+	FArrayBox empty;
+	fbox.swap(empty);
+}
+
+/* Called after a regrid.  Error fields are recomputed at the next output,
+   and time interpolated data is only needed on levels that have a finer
+   level to fill ghost cells for.  Whatever the pool then holds unused is
+   returned to the system. */
+static
+void clawpatch_release_memory(fclaw2d_global_t *glob)
+{
+	const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+	fclaw2d_domain_t *domain = glob->domain;
+	for (int nb = 0; nb < domain->num_blocks; nb++)
+	{
+		fclaw2d_block_t *block = &domain->blocks[nb];
+		for (int np = 0; np < block->num_patches; np++)
+		{
+			fclaw2d_patch_t *patch = &block->patches[np];
+			fclaw2d_clawpatch_t *cp = get_clawpatch(patch);
+			if (!fclaw_opt->subcycle || patch->level >= domain->global_maxlevel)
+			{
+				release_optional_field(cp->griddata_time_interpolated);
+			}
+			release_optional_field(cp->griderror);
+			release_optional_field(cp->exactsolution);
+		}
+	}
+	fclaw2d_farraybox_pool_trim();
+}
+
+/* ------------------------------- Memory report ------------------------------------ */
+
+static
+void clawpatch_memory_count(fclaw2d_clawpatch_t *cp,
+							FArrayBox fclaw2d_clawpatch_t::*const fields[],
+							int num_fields, double field_bytes[],
+							double *level_bytes)
+{
+	for (int i = 0; i < num_fields; i++)
+	{
+		double bytes = (double) (cp->*fields[i]).size()*sizeof(double);
+		field_bytes[i] += bytes;
+		*level_bytes += bytes;
+	}
+
+	/* A single precision copy is counted with griddata_last */
+	double last_bytes = (double) cp->griddata_last_float.size()*sizeof(float);
+	field_bytes[1] += last_bytes;
+	*level_bytes += last_bytes;
+}
+
+/* Bytes held by each clawpatch field and by each level, summed over local
+   and ghost patches, plus what the FArrayBox pool has reserved.  Reported
+   in MB with min/max/average over all ranks. */
+static
+void clawpatch_memory_report(fclaw2d_global_t *glob)
+{
+	static FArrayBox fclaw2d_clawpatch_t::*const fields[] = 
+	{
+		&fclaw2d_clawpatch_t::griddata,
+		&fclaw2d_clawpatch_t::griddata_last,
+		&fclaw2d_clawpatch_t::griddata_save,
+		&fclaw2d_clawpatch_t::griddata_time_interpolated,
+		&fclaw2d_clawpatch_t::griderror,
+		&fclaw2d_clawpatch_t::exactsolution,
+		&fclaw2d_clawpatch_t::rhs,
+		&fclaw2d_clawpatch_t::elliptic_error,
+		&fclaw2d_clawpatch_t::elliptic_soln,
+		&fclaw2d_clawpatch_t::aux,
+		&fclaw2d_clawpatch_t::aux_save
+	};
+	static const char *field_names[] = 
+	{
+		"MEMORY_Q", "MEMORY_Q_LAST", "MEMORY_Q_SAVE", "MEMORY_Q_TIMEINTERP",
+		"MEMORY_ERROR", "MEMORY_EXACT", "MEMORY_RHS", "MEMORY_ELLIPTIC_ERROR",
+		"MEMORY_ELLIPTIC_SOLN", "MEMORY_AUX", "MEMORY_AUX_SAVE"
+	};
+	const int num_fields = sizeof(fields)/sizeof(fields[0]);
+
+	const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+	int num_levels = fclaw_opt->maxlevel + 1;
+
+	std::vector<double> field_bytes(num_fields, 0.0);
+	std::vector<double> level_bytes(num_levels, 0.0);
+
+	fclaw2d_domain_t *domain = glob->domain;
+	for (int nb = 0; nb < domain->num_blocks; nb++)
+	{
+		fclaw2d_block_t *block = &domain->blocks[nb];
+		for (int np = 0; np < block->num_patches; np++)
+		{
+			fclaw2d_patch_t *patch = &block->patches[np];
+			int level = SC_MIN(patch->level, num_levels - 1);
+			clawpatch_memory_count(get_clawpatch(patch), fields, num_fields,
+								   field_bytes.data(), &level_bytes[level]);
+		}
+	}
+	for (int i = 0; i < domain->num_ghost_patches; i++)
+	{
+		fclaw2d_patch_t *patch = &domain->ghost_patches[i];
+		if (patch->user == NULL)
+		{
+			continue;
+		}
+		int level = SC_MIN(patch->level, num_levels - 1);
+		clawpatch_memory_count(get_clawpatch(patch), fields, num_fields,
+							   field_bytes.data(), &level_bytes[level]);
+	}
+
+	size_t pool_reserved, pool_in_use;
+	fclaw2d_farraybox_pool_stats(&pool_reserved, &pool_in_use);
+
+	const double mb = 1024.0*1024.0;
+	int count = num_fields + num_levels + 2;
+	std::vector<sc_statinfo_t> stats(count);
+	std::vector<std::string> level_names(num_levels);
+
+	for (int i = 0; i < num_fields; i++)
+	{
+		sc_stats_set1(&stats[i], field_bytes[i]/mb, field_names[i]);
+	}
+	for (int level = 0; level < num_levels; level++)
+	{
+		level_names[level] = "MEMORY_LEVEL_" + std::to_string(level);
+		sc_stats_set1(&stats[num_fields + level], level_bytes[level]/mb,
+					  level_names[level].c_str());
+	}
+	sc_stats_set1(&stats[count - 2], pool_reserved/mb, "MEMORY_POOL_RESERVED");
+	sc_stats_set1(&stats[count - 1], pool_in_use/mb, "MEMORY_POOL_IN_USE");
+
+	sc_stats_compute(glob->mpicomm, count, stats.data());
+
+	fclaw_global_essentialf("Patch memory (MB)\n");
+	sc_stats_print(sc_package_id, SC_LP_ESSENTIAL, count, stats.data(), 1, 0);
 }
 
 /* ------------------------------------ Virtual table  -------------------------------- */
@@ -1343,6 +1973,7 @@ void fclaw2d_clawpatch_vtable_initialize(fclaw2d_global_t* glob,
 	/* Time stepping */
 	patch_vt->restore_step          = clawpatch_restore_step;
 	patch_vt->save_step             = clawpatch_save_step;
+	patch_vt->begin_update          = clawpatch_begin_update;
 	patch_vt->setup_timeinterp      = clawpatch_setup_timeinterp;
 
 	/* Ghost filling */
@@ -1388,6 +2019,9 @@ void fclaw2d_clawpatch_vtable_initialize(fclaw2d_global_t* glob,
 	patch_vt->partition_packsize   = clawpatch_partition_packsize;
 	patch_vt->partition_pack       = clawpatch_partition_pack;
 	patch_vt->partition_unpack     = clawpatch_partition_unpack;
+	patch_vt->pack_levels          = clawpatch_pack_levels;
+	patch_vt->release_memory       = clawpatch_release_memory;
+	patch_vt->memory_report        = clawpatch_memory_report;
 
 	/* output functions */
 	clawpatch_vt->time_header_ascii  = fclaw2d_clawpatch_time_header_ascii;
@@ -1547,7 +2181,61 @@ void fclaw2d_clawpatch_save_current_step(fclaw2d_global_t* glob,
 										 fclaw2d_patch_t* patch)
 {
 	fclaw2d_clawpatch_t *cp = get_clawpatch(patch);
-	cp->griddata_last = cp->griddata;
+	if (cp->griddata_adopted)
+	{
+		/* As in clawpatch_begin_update */
+		clawpatch_release_adopted(cp);
+	}
+	if (cp->save_pending)
+	{
+		/* Solver called outside of fclaw2d_patch_single_step_update */
+		clawpatch_commit_saved_step(glob,cp);
+	}
+	const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+	const fclaw2d_clawpatch_options_t *clawpatch_opt = fclaw2d_clawpatch_get_options(glob);
+	if (fclaw_opt->tag_reuse_tolerance > 0 && !cp->step_change_counted)
+	{
+		/* Bound the change of the last step for regrid tagging while copying */
+		clawpatch_count_step_change(glob,cp,1);
+	}
+	else if (clawpatch_opt->reduced_precision)
+		copy_to_float(cp->griddata_last_float, cp->griddata);
+	else
+		cp->griddata_last = cp->griddata;
+	cp->step_change_counted = 0;
+	cp->tag_refine.fresh = 0;
+}
+
+void fclaw2d_clawpatch_tag_after_update(fclaw2d_global_t* glob,
+										fclaw2d_patch_t* patch,
+										int blockno,
+										double t, double dt)
+{
+	const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+	if (!glob->tag_in_update || fclaw_opt->refine_threshold < 0 ||
+	    patch->level >= fclaw_opt->maxlevel)
+	{
+		return;
+	}
+	if (!fclaw2d_clawpatch_vt(glob)->tag4refinement_interior_only)
+	{
+		/* The criteria read ghost cells, which are only valid after the
+		   ghost update that precedes the regrid */
+		return;
+	}
+	if (t + 1.5*dt < glob->tag_in_update_time)
+	{
+		/* Patch is updated again before the regrid */
+		return;
+	}
+
+	/* The global glob is set by fclaw2d_update_single_step, outside of
+	   the threads. */
+	FCLAW_ASSERT(fclaw2d_global_get_global() == glob);
+	fclaw2d_clawpatch_t *cp = get_clawpatch(patch);
+	int tag_patch = clawpatch_tag4refinement_compute(glob,patch,blockno,0);
+	tag_cache_store(cp->tag_refine,tag_patch);
+	cp->tag_refine.fresh = 1;
 }
 
 
@@ -1651,7 +2339,7 @@ void fclaw2d_clawpatch_elliptic_error_data(fclaw2d_global_t* glob,
                                            double **err, int *mfields)
 {
 	fclaw2d_clawpatch_t *cp = get_clawpatch(patch);
-	*err = cp->elliptic_error.dataPtr();
+	*err = optional_field(cp,cp->elliptic_error,cp->mfields).dataPtr();
 	*mfields = cp->mfields;
 }
 
@@ -1660,7 +2348,7 @@ void fclaw2d_clawpatch_elliptic_soln_data(fclaw2d_global_t* glob,
                                            double **soln, int *mfields)
 {
 	fclaw2d_clawpatch_t *cp = get_clawpatch(patch);
-	*soln = cp->elliptic_soln.dataPtr();
+	*soln = optional_field(cp,cp->elliptic_soln,cp->mfields).dataPtr();
 	*mfields = cp->mfields;
 }
 
@@ -1685,14 +2373,14 @@ double* fclaw2d_clawpatch_get_error(fclaw2d_global_t* glob,
 									fclaw2d_patch_t* patch)
 {
 	fclaw2d_clawpatch_t *cp = get_clawpatch(patch);
-	return cp->griderror.dataPtr();
+	return optional_field(cp,cp->griderror,cp->meqn).dataPtr();
 }
 
 double* fclaw2d_clawpatch_get_exactsoln(fclaw2d_global_t* glob,
 									fclaw2d_patch_t* patch)
 {
 	fclaw2d_clawpatch_t *cp = get_clawpatch(patch);
-	return cp->exactsolution.dataPtr();
+	return optional_field(cp,cp->exactsolution,cp->meqn).dataPtr();
 }
 
 void* fclaw2d_clawpatch_get_user_data(fclaw2d_global_t* glob,
@@ -103,6 +103,30 @@ clawpatch_register(fclaw2d_clawpatch_options_t *clawpatch_options,
                          &clawpatch_options->save_aux,0,
                          "Save aux variables when re-taking a time step [F]");
 
+    sc_options_add_bool (opt, 0, "level-storage", 
+                         &clawpatch_options->level_storage,0,
+                         "Store solution and aux data of a level in one array [F]");
+
+    sc_options_add_bool (opt, 0, "reduced-precision", 
+                         &clawpatch_options->reduced_precision,0,
+                         "Store the last solution copy in single precision [F]");
+
+    sc_options_add_bool (opt, 0, "ghost-pack-float", 
+                         &clawpatch_options->ghost_pack_float,0,
+                         "Send ghost patch data in single precision [F]");
+
+    sc_options_add_bool (opt, 0, "partition-pack-interior", 
+                         &clawpatch_options->partition_pack_interior,0,
+                         "Send only interior cells when partitioning; ghost cells " 
+                         "are set by the next ghost update.  Requires "
+                         "init_ghostcell [F]");
+
+    sc_options_add_bool (opt, 0, "partition-adopt", 
+                         &clawpatch_options->partition_adopt,0,
+                         "Use the data received when partitioning as patch storage "
+                         "until the patch is next updated, instead of copying it "
+                         "on receipt [F]");
+
     /* Set verbosity level for reporting timing */
     sc_keyvalue_t *kv = clawpatch_options->kv_refinement_criteria = kv_refinement_criterea_new();
     sc_options_add_keyvalue (opt, 0, "refinement-criteria", 
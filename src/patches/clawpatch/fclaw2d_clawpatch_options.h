@@ -84,6 +84,11 @@ struct fclaw2d_clawpatch_options
     int interp_stencil_width; /**< The width of the interpolation stencil */
     int ghost_patch_pack_aux; /**< True if aux equations should be packed */
     int save_aux;             /**< Save the aux array when retaking a time step */
+    int level_storage;        /**< Store patch data of a level contiguously */
+    int reduced_precision;    /**< Store the last solution copy in single precision */
+    int ghost_pack_float;     /**< Send ghost patch strips in single precision */
+    int partition_pack_interior; /**< Send only interior cells when partitioning */
+    int partition_adopt;      /**< Use received partition data as patch storage */
 
 
     int is_registered; /**< true if options have been registered */
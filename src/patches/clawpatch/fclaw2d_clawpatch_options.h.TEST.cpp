@@ -152,6 +152,11 @@ TEST_CASE("fclaw2d_clawpatch_options packing/unpacking")
 	opts->interp_stencil_width = 3;
 	opts->ghost_patch_pack_aux = 7;
 	opts->save_aux = 1;
+	opts->level_storage = 1;
+	opts->reduced_precision = 1;
+	opts->ghost_pack_float = 1;
+	opts->partition_pack_interior = 1;
+	opts->partition_adopt = 1;
 	opts->is_registered = 1;
 
 	const fclaw_packing_vtable_t* vt = fclaw2d_clawpatch_options_get_packing_vtable();
@@ -177,6 +182,11 @@ TEST_CASE("fclaw2d_clawpatch_options packing/unpacking")
 	CHECK_EQ(output_opts->interp_stencil_width,opts->interp_stencil_width);
 	CHECK_EQ(output_opts->ghost_patch_pack_aux,opts->ghost_patch_pack_aux);
 	CHECK_EQ(output_opts->save_aux,opts->save_aux);
+	CHECK_EQ(output_opts->level_storage,opts->level_storage);
+	CHECK_EQ(output_opts->reduced_precision,opts->reduced_precision);
+	CHECK_EQ(output_opts->ghost_pack_float,opts->ghost_pack_float);
+	CHECK_EQ(output_opts->partition_pack_interior,opts->partition_pack_interior);
+	CHECK_EQ(output_opts->partition_adopt,opts->partition_adopt);
 	CHECK_EQ(output_opts->is_registered,opts->is_registered);
 
 	vt->destroy(output_opts);
@@ -197,6 +207,11 @@ TEST_CASE("fclaw3dx_clawpatch_options packing/unpacking")
 	opts->interp_stencil_width = 3;
 	opts->ghost_patch_pack_aux = 7;
 	opts->save_aux = 1;
+	opts->level_storage = 1;
+	opts->reduced_precision = 1;
+	opts->ghost_pack_float = 1;
+	opts->partition_pack_interior = 1;
+	opts->partition_adopt = 1;
 	opts->is_registered = 1;
 
 	const fclaw_packing_vtable_t* vt = fclaw3dx_clawpatch_options_get_packing_vtable();
@@ -223,6 +238,11 @@ TEST_CASE("fclaw3dx_clawpatch_options packing/unpacking")
 	CHECK_EQ(output_opts->interp_stencil_width,opts->interp_stencil_width);
 	CHECK_EQ(output_opts->ghost_patch_pack_aux,opts->ghost_patch_pack_aux);
 	CHECK_EQ(output_opts->save_aux,opts->save_aux);
+	CHECK_EQ(output_opts->level_storage,opts->level_storage);
+	CHECK_EQ(output_opts->reduced_precision,opts->reduced_precision);
+	CHECK_EQ(output_opts->ghost_pack_float,opts->ghost_pack_float);
+	CHECK_EQ(output_opts->partition_pack_interior,opts->partition_pack_interior);
+	CHECK_EQ(output_opts->partition_adopt,opts->partition_adopt);
 	CHECK_EQ(output_opts->is_registered,opts->is_registered);
 
 	vt->destroy(output_opts);
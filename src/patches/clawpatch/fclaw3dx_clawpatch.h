@@ -213,6 +213,10 @@ struct fclaw3dx_clawpatch_vtable
 
     /** Tags a patch for refinement. */
     fclaw3dx_clawpatch_fort_tag4refinement_t        fort_tag4refinement;
+    /** True if fort_tag4refinement reads no ghost cells, so that it can be
+        evaluated right after the update (option tag-in-update).  The
+        default routines read ghost cells. */
+    int tag4refinement_interior_only;
     /** Tags a quad of patches for coarsening. */
     fclaw3dx_clawpatch_fort_tag4coarsening_t        fort_tag4coarsening;
     /** @deprecated Checks if solution exceeds a threshold */
@@ -300,6 +304,10 @@ struct fclaw3dx_clawpatch_vtable
 /**
  * @brief Save the current timestep
  * 
+ * Solvers must call this before they first modify the solution in a
+ * time step.  This is also where a step saved by fclaw2d_patch_save_step
+ * is copied.
+ * 
  * @param[in]  glob glob the global context
  * @param[in]  patch the patch context
  */
@@ -307,6 +315,27 @@ void fclaw3dx_clawpatch_save_current_step(struct fclaw2d_global* glob,
                                           struct fclaw2d_patch* patch);
 
 
+/**
+ * @brief Tag a patch for refinement right after its update
+ * 
+ * Solvers call this after updating the solution.  If the option tag-in-update
+ * is set and the run loop regrids after this update, the refinement criteria
+ * are evaluated while the new solution is still in cache.  Regridding then
+ * uses the stored tag instead of sweeping the patch again.  Ghost cells
+ * still hold values from before the update, so this is only done if the
+ * vtable sets tag4refinement_interior_only.  Otherwise the patch is tagged
+ * at the regrid, as without tag-in-update.
+ * 
+ * @param[in]  glob the global context
+ * @param[in]  patch the patch context
+ * @param[in]  blockno the block number
+ * @param[in]  t, dt the start time and size of the update
+ */
+void fclaw3dx_clawpatch_tag_after_update(struct fclaw2d_global* glob,
+                                          struct fclaw2d_patch* patch,
+                                          int blockno,
+                                          double t, double dt);
+
 /* ------------------------------- Misc access functions ------------------------------ */
 
 /**
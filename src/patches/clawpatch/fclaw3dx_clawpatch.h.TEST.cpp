@@ -39,6 +39,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <test/test.hpp>
 #include <fstream>
 #include <bitset>
+#include <cstring>
+#include <vector>
 
 #include <fclaw2d_forestclaw.h>
 
@@ -198,6 +200,7 @@ TEST_CASE("fclaw3dx_clawpatch_vtable_initialize")
 
     //regridding
     CHECK(clawpatch_vt->fort_tag4refinement         == &FCLAW3DX_CLAWPATCH46_FORT_TAG4REFINEMENT);
+    CHECK(clawpatch_vt->tag4refinement_interior_only == 0);
     CHECK(clawpatch_vt->fort_tag4coarsening         == &FCLAW3DX_CLAWPATCH46_FORT_TAG4COARSENING);
     CHECK(clawpatch_vt->fort_user_exceeds_threshold == NULL);
     CHECK(clawpatch_vt->fort_interpolate2fine       == &FCLAW3DX_CLAWPATCH46_FORT_INTERPOLATE2FINE);
@@ -324,30 +327,17 @@ TEST_CASE("fclaw3dx_clawpatch patch_build")
             CHECK_BOX_EMPTY(cp->griddata_last);
             CHECK_BOX_EMPTY(cp->griddata_save);
         }
-        if(fopts.subcycle){
-            CHECK_BOX_DIMENSIONS(cp->griddata_time_interpolated, opts.mbc, opts.mx, opts.my, opts.mz, opts.meqn);
-        }else{
-            CHECK_BOX_EMPTY(cp->griddata_time_interpolated);
-        }
-        if(fopts.compute_error) {
-            CHECK_BOX_DIMENSIONS(cp->griderror, opts.mbc, opts.mx, opts.my, opts.mz, opts.meqn);
-            CHECK_BOX_DIMENSIONS(cp->exactsolution, opts.mbc, opts.mx, opts.my, opts.mz, opts.meqn);
-        }else{
-            CHECK_BOX_EMPTY(cp->griderror);
-            CHECK_BOX_EMPTY(cp->exactsolution);
-        }
+        //optional fields are allocated on first use
+        CHECK_BOX_EMPTY(cp->griddata_time_interpolated);
+        CHECK_BOX_EMPTY(cp->griderror);
+        CHECK_BOX_EMPTY(cp->exactsolution);
         if(opts.rhs_fields == 0){
             CHECK_BOX_EMPTY(cp->rhs);
         }else{
             CHECK_BOX_DIMENSIONS(cp->rhs, opts.mbc, opts.mx, opts.my, opts.mz, opts.rhs_fields);
         }
-        if(opts.rhs_fields == 0 || !fopts.compute_error) {
-            CHECK_BOX_EMPTY(cp->elliptic_error);
-            CHECK_BOX_EMPTY(cp->elliptic_soln);
-        }else{
-            CHECK_BOX_DIMENSIONS(cp->elliptic_error, opts.mbc, opts.mx, opts.my, opts.mz, opts.rhs_fields);
-            CHECK_BOX_DIMENSIONS(cp->elliptic_soln, opts.mbc, opts.mx, opts.my, opts.mz, opts.rhs_fields);
-        }
+        CHECK_BOX_EMPTY(cp->elliptic_error);
+        CHECK_BOX_EMPTY(cp->elliptic_soln);
 
         fclaw2d_patch_data_delete(glob, &domain->blocks[0].patches[0]);
         fclaw2d_global_destroy(glob);
@@ -362,9 +352,85 @@ TEST_CASE("fclaw3dx_clawpatch save_step")
     fclaw3dx_clawpatch_t* cp = fclaw3dx_clawpatch_get_clawpatch(&test_data.domain->blocks[0].patches[0]);
     cp->griddata.dataPtr()[0] = 1234;
     fclaw2d_patch_save_step(test_data.glob,&test_data.domain->blocks[0].patches[0]);
+
+    /* The copy is made before the solver first writes to the patch */
+    fclaw3dx_clawpatch_save_current_step(test_data.glob,&test_data.domain->blocks[0].patches[0]);
     CHECK(cp->griddata_save.dataPtr()[0] == 1234);
 }
 
+TEST_CASE("fclaw3dx_clawpatch restore_step without update")
+{
+    SinglePatchDomain test_data;
+    test_data.setup();
+
+    fclaw3dx_clawpatch_t* cp = fclaw3dx_clawpatch_get_clawpatch(&test_data.domain->blocks[0].patches[0]);
+    cp->griddata.dataPtr()[0] = 1234;
+    fclaw2d_patch_save_step(test_data.glob,&test_data.domain->blocks[0].patches[0]);
+    fclaw2d_patch_restore_step(test_data.glob,&test_data.domain->blocks[0].patches[0]);
+    CHECK(cp->griddata.dataPtr()[0] == 1234);
+}
+
+namespace{
+double test_update_with_b4step2(fclaw2d_global_t *glob,
+                                fclaw2d_patch_t *patch,
+                                int blockno,
+                                int patchno,
+                                double t,
+                                double dt,
+                                void *user)
+{
+    fclaw3dx_clawpatch_t* cp = fclaw3dx_clawpatch_get_clawpatch(patch);
+    /* b4step2 runs before the solver saves the current step */
+    cp->griddata.dataPtr()[0] = 1;
+    fclaw3dx_clawpatch_save_current_step(glob,patch);
+    cp->griddata.dataPtr()[0] = 2;
+    return 0;
+}
+}
+
+TEST_CASE("fclaw3dx_clawpatch restore_step after b4step2")
+{
+    SinglePatchDomain test_data;
+    test_data.setup();
+
+    fclaw2d_patch_t* patch = &test_data.domain->blocks[0].patches[0];
+    fclaw3dx_clawpatch_t* cp = fclaw3dx_clawpatch_get_clawpatch(patch);
+    cp->griddata.dataPtr()[0] = 1234;
+    fclaw2d_patch_save_step(test_data.glob,patch);
+
+    fclaw2d_patch_vt(test_data.glob)->single_step_update = test_update_with_b4step2;
+    fclaw2d_patch_single_step_update(test_data.glob,patch,0,0,0,1,NULL);
+    CHECK(cp->griddata.dataPtr()[0] == 2);
+
+    fclaw2d_patch_restore_step(test_data.glob,patch);
+    CHECK(cp->griddata.dataPtr()[0] == 1234);
+}
+
+TEST_CASE("fclaw3dx_clawpatch restore_step with reduced_precision")
+{
+    SinglePatchDomain test_data;
+    test_data.opts.reduced_precision = 1;
+    test_data.setup();
+
+    fclaw2d_patch_t* patch = &test_data.domain->blocks[0].patches[0];
+    fclaw3dx_clawpatch_t* cp = fclaw3dx_clawpatch_get_clawpatch(patch);
+    int size = cp->griddata.size();
+    double* q = cp->griddata.dataPtr();
+    /* Values that do not survive a round trip through float */
+    for(int i = 0; i < size; i++){
+        q[i] = 1.0/3.0 + i*1e-12;
+    }
+    std::vector<double> original(q, q + size);
+    fclaw2d_patch_save_step(test_data.glob,patch);
+
+    fclaw2d_patch_vt(test_data.glob)->single_step_update = test_update_with_b4step2;
+    fclaw2d_patch_single_step_update(test_data.glob,patch,0,0,0,1,NULL);
+
+    fclaw2d_patch_restore_step(test_data.glob,patch);
+    REQUIRE(cp->griddata.size() == size);
+    CHECK(memcmp(cp->griddata.dataPtr(), original.data(), size*sizeof(double)) == 0);
+}
+
 TEST_CASE("fclaw3dx_clawpatch_save_current_step")
 {
     SinglePatchDomain test_data;
@@ -522,6 +588,7 @@ TEST_CASE("fclaw3dx_clawpatch_elliptic_error_data")
 
     CHECK(rhs == cp->elliptic_error.dataPtr());
     CHECK(mfields == test_data.opts.rhs_fields);
+    CHECK_BOX_DIMENSIONS(cp->elliptic_error, test_data.opts.mbc, test_data.opts.mx, test_data.opts.my, test_data.opts.mz, test_data.opts.rhs_fields);
 }
 
 TEST_CASE("fclaw3dx_clawpatch_elliptic_soln_data")
@@ -537,6 +604,7 @@ TEST_CASE("fclaw3dx_clawpatch_elliptic_soln_data")
 
     CHECK(rhs == cp->elliptic_soln.dataPtr());
     CHECK(mfields == test_data.opts.rhs_fields);
+    CHECK_BOX_DIMENSIONS(cp->elliptic_soln, test_data.opts.mbc, test_data.opts.mx, test_data.opts.my, test_data.opts.mz, test_data.opts.rhs_fields);
 }
 
 TEST_CASE("fclaw3dx_clawpatch_get_q")
@@ -569,7 +637,10 @@ TEST_CASE("fclaw3dx_clawpatch_get_error")
     //CHECK
     fclaw3dx_clawpatch_t* cp = fclaw3dx_clawpatch_get_clawpatch(&test_data.domain->blocks[0].patches[0]);
 
-    CHECK(fclaw3dx_clawpatch_get_error(test_data.glob,&test_data.domain->blocks[0].patches[0]) == cp->griderror.dataPtr());
+    double* q = fclaw3dx_clawpatch_get_error(test_data.glob,&test_data.domain->blocks[0].patches[0]);
+
+    CHECK(q == cp->griderror.dataPtr());
+    CHECK_BOX_DIMENSIONS(cp->griderror, test_data.opts.mbc, test_data.opts.mx, test_data.opts.my, test_data.opts.mz, test_data.opts.meqn);
 }
 
 TEST_CASE("fclaw3dx_clawpatch_get_exact_soln")
@@ -580,7 +651,24 @@ TEST_CASE("fclaw3dx_clawpatch_get_exact_soln")
     //CHECK
     fclaw3dx_clawpatch_t* cp = fclaw3dx_clawpatch_get_clawpatch(&test_data.domain->blocks[0].patches[0]);
 
-    CHECK(fclaw3dx_clawpatch_get_exactsoln(test_data.glob,&test_data.domain->blocks[0].patches[0]) == cp->exactsolution.dataPtr());
+    double* q = fclaw3dx_clawpatch_get_exactsoln(test_data.glob,&test_data.domain->blocks[0].patches[0]);
+
+    CHECK(q == cp->exactsolution.dataPtr());
+    CHECK_BOX_DIMENSIONS(cp->exactsolution, test_data.opts.mbc, test_data.opts.mx, test_data.opts.my, test_data.opts.mz, test_data.opts.meqn);
+}
+namespace{
+/* griddata_time_interpolated is only allocated by setup_timeinterp */
+void allocate_time_interpolated(SinglePatchDomain& test_data)
+{
+    fclaw3dx_clawpatch_vtable_t * clawpatch_vt = fclaw3dx_clawpatch_vt(test_data.glob);
+    clawpatch_vt->fort_timeinterp = [] (const int *mx, const int *my, const int *mz, 
+                                        const int *mbc, const int *meqn, const int *psize, 
+                                        double qcurr[], double qlast[], double qinterp[], 
+                                        const double *alpha, const int *ierror)
+    {
+    };
+    fclaw2d_patch_setup_timeinterp(test_data.glob, &test_data.domain->blocks[0].patches[0], 0.5);
+}
 }
 TEST_CASE("fclaw3dx_clawpatch_timesync_data")
 {
@@ -591,10 +679,14 @@ TEST_CASE("fclaw3dx_clawpatch_timesync_data")
 
         //CHECK
         fclaw3dx_clawpatch_t* cp = fclaw3dx_clawpatch_get_clawpatch(&test_data.domain->blocks[0].patches[0]);
+        if(time_interp){
+            allocate_time_interpolated(test_data);
+        }
         double* q;
         int meqn;
         fclaw3dx_clawpatch_timesync_data(test_data.glob, &test_data.domain->blocks[0].patches[0], time_interp, &q, &meqn);
 
+        CHECK(q != NULL);
         if(time_interp){
             CHECK(q == cp->griddata_time_interpolated.dataPtr());
         } else {
@@ -614,12 +706,39 @@ TEST_CASE("fclaw3dx_clawpatch_get_q_timesync")
         fclaw3dx_clawpatch_t* cp = fclaw3dx_clawpatch_get_clawpatch(&test_data.domain->blocks[0].patches[0]);
 
         if(time_interp){
+            allocate_time_interpolated(test_data);
+            CHECK(cp->griddata_time_interpolated.dataPtr() != NULL);
             CHECK(fclaw3dx_clawpatch_get_q_timesync(test_data.glob,&test_data.domain->blocks[0].patches[0],time_interp) == cp->griddata_time_interpolated.dataPtr());
         } else {
             CHECK(fclaw3dx_clawpatch_get_q_timesync(test_data.glob,&test_data.domain->blocks[0].patches[0],time_interp) == cp->griddata.dataPtr());
         }
     }
 }
+TEST_CASE("fclaw3dx_clawpatch release_memory drops optional fields")
+{
+    SinglePatchDomain test_data;
+    test_data.setup();
+
+    fclaw3dx_clawpatch_t* cp = fclaw3dx_clawpatch_get_clawpatch(&test_data.domain->blocks[0].patches[0]);
+    allocate_time_interpolated(test_data);
+    fclaw3dx_clawpatch_get_error(test_data.glob,&test_data.domain->blocks[0].patches[0]);
+    fclaw3dx_clawpatch_get_exactsoln(test_data.glob,&test_data.domain->blocks[0].patches[0]);
+    REQUIRE(cp->griddata_time_interpolated.dataPtr() != NULL);
+    REQUIRE(cp->griderror.dataPtr() != NULL);
+    REQUIRE(cp->exactsolution.dataPtr() != NULL);
+
+    /* The only patch is on the finest level */
+    fclaw2d_patch_release_memory(test_data.glob);
+
+    CHECK(cp->griddata_time_interpolated.dataPtr() == NULL);
+    CHECK(cp->griderror.dataPtr() == NULL);
+    CHECK(cp->exactsolution.dataPtr() == NULL);
+    CHECK(cp->griddata.dataPtr() != NULL);
+
+    /* Fields come back the next time they are asked for */
+    CHECK(fclaw3dx_clawpatch_get_error(test_data.glob,&test_data.domain->blocks[0].patches[0]) == cp->griderror.dataPtr());
+    CHECK(cp->griderror.dataPtr() != NULL);
+}
 TEST_CASE("fclaw3dx_clawpatch user_data")
 {
     SinglePatchDomain test_data;
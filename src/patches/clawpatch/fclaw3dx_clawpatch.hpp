@@ -32,6 +32,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 #include <fclaw2d_farraybox.hpp>  /* Needed for FArray boxes */
 
+#include <vector>
+
 struct fclaw2d_patch;
 struct fclaw2d_global;
 struct fclaw3d_metric_patch_t;
@@ -47,9 +49,26 @@ public :
     FArrayBox griddata; /**< the current solution */
     FArrayBox griddata_last; /**< the solution at the last timestep */
     FArrayBox griddata_save; /**< the saved solution */
+    int save_pending; /**< step saved, but not yet copied to griddata_save */
+    int griddata_adopted; /**< griddata views the data received in a partition */
+    std::vector<float> griddata_last_float; /**< griddata_last, if stored in single precision */
     FArrayBox griddata_time_interpolated; /**< the time interpolated solution */
     FArrayBox griderror; /**< the error */
 
+    /** Last regrid tag of a patch, reused while the solution barely changes
+        (see the option tag-reuse-tolerance) */
+    struct tag_cache
+    {
+        int valid;     /**< true if tag holds a decision */
+        int fresh;     /**< true if made after the last update */
+        int tag;       /**< the last decision */
+        int steps;     /**< steps taken since the decision */
+        double change; /**< bound on max |q - q at the decision| */
+    };
+    tag_cache tag_refine; /**< refinement tag */
+    tag_cache tag_coarsen; /**< coarsening tag of the family starting here */
+    int step_change_counted; /**< change of the last step is in the bounds */
+
     /** Exact solution for diagnostics */
     FArrayBox exactsolution;
 
@@ -62,6 +62,17 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <fclaw2d_global.h>
 #include <fclaw2d_patch.h>  
+#include <fclaw2d_options.h>
+#include <fclaw2d_map.h>
+#include <fclaw2d_map_query.h>
+
+#include <string.h>
+
+#include <list>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
 
 static
 fclaw2d_metric_patch_t* get_metric_patch(fclaw2d_global_t* glob,
@@ -71,11 +82,335 @@ fclaw2d_metric_patch_t* get_metric_patch(fclaw2d_global_t* glob,
 }
 
 
+/* ------------------------------- Shared basis terms --------------------------------- */
+
+#if PATCH_DIM == 2
+/* With an affine map, normals, tangents, edge lengths, surface normals and
+   curvature are the same for every patch on a given block and level.  One
+   read-only copy is kept per (block, level) for the whole run;  patches hold
+   views into it.  Mesh coordinates and area stay with each patch. */
+struct fclaw2d_metric_shared_basis
+{
+    std::shared_ptr<double> storage;
+    int computed;
+};
+
+struct fclaw2d_metric_shared
+{
+    std::map<std::pair<int,int>, fclaw2d_metric_shared_basis> basis;
+};
+
+static
+size_t box_size(const Box& box)
+{
+    size_t size = 1;
+    for (int idir = 0; idir < box.boxDim(); idir++)
+    {
+        size *= box.bigEnd(idir) - box.smallEnd(idir) + 1;
+    }
+    return size;
+}
+
+static
+void metric_define_shared_basis(fclaw2d_global_t *glob,
+                                fclaw2d_metric_patch_t *mp, int level,
+                                const Box& box_p, const Box& box_d)
+{
+    fclaw2d_metric_vtable_t *metric_vt = fclaw2d_metric_vt(glob);
+    size_t np = box_size(box_p);
+    size_t nd = box_size(box_d);
+    fclaw2d_metric_shared_basis *sb;
+
+#pragma omp critical(fclaw2d_metric_shared)
+    {
+        if (metric_vt->shared == NULL)
+        {
+            metric_vt->shared = new fclaw2d_metric_shared;
+        }
+        sb = &metric_vt->shared->basis[std::make_pair(mp->blockno,level)];
+        if (!sb->storage)
+        {
+            sb->storage = fclaw2d_farraybox_storage_new(14*nd + 4*np);
+            sb->computed = 0;
+        }
+    }
+
+    double *data = sb->storage.get();
+    mp->xface_normals.define_view(box_d,3,sb->storage,data);   data += 3*nd;
+    mp->yface_normals.define_view(box_d,3,sb->storage,data);   data += 3*nd;
+    mp->xface_tangents.define_view(box_d,3,sb->storage,data);  data += 3*nd;
+    mp->yface_tangents.define_view(box_d,3,sb->storage,data);  data += 3*nd;
+    mp->edge_lengths.define_view(box_d,2,sb->storage,data);    data += 2*nd;
+    mp->surf_normals.define_view(box_p,3,sb->storage,data);    data += 3*np;
+    mp->curvature.define_view(box_p,1,sb->storage,data);
+    mp->shared_basis = sb;
+}
+#endif
+
+/* Shared basis terms are computed by the first patch built on their block 
+   and level */
+static
+void metric_compute_basis(fclaw2d_global_t *glob,
+                          fclaw2d_patch_t *patch,
+                          int blockno, int patchno)
+{
+    fclaw2d_metric_vtable_t *metric_vt = fclaw2d_metric_vt(glob);
+    if (metric_vt->compute_basis == NULL)
+    {
+        return;
+    }
+#if PATCH_DIM == 2
+    fclaw2d_metric_patch_t* mp = get_metric_patch(glob, patch);
+    if (mp->shared_basis != NULL)
+    {
+#pragma omp critical(fclaw2d_metric_shared)
+        {
+            if (!mp->shared_basis->computed)
+            {
+                metric_vt->compute_basis(glob,patch,blockno,patchno);
+                mp->shared_basis->computed = 1;
+            }
+        }
+        return;
+    }
+#endif
+    metric_vt->compute_basis(glob,patch,blockno,patchno);
+}
+
+/* ------------------------------- Metric cache ------------------------------------- */
+
+/* Metric terms of recently built patches, keyed by block, level and position
+   of the quadrant.  Patches that come back after coarsening, refinement or
+   partitioning copy their geometry from here instead of evaluating the
+   mapping again.  Least recently used entries are dropped once the cache
+   holds metric_cache_size patches. 
+
+   Areas are only cached when computed from the mapping;  areas averaged
+   from fine grids are never stored, so a coarse grid area is still the sum
+   of its fine grid areas. */
+enum
+{
+    METRIC_CACHE_MESH  = 1,
+    METRIC_CACHE_AREA  = 2,
+    METRIC_CACHE_BASIS = 4
+};
+
+#if PATCH_DIM == 2
+typedef std::tuple<int,int,int,int> metric_cache_key_t;
+
+/* Stored terms are never modified, only replaced, so readers can copy
+   from them after leaving the critical section */
+typedef std::shared_ptr<const std::vector<double> > metric_cache_data_t;
+
+struct metric_cache_entry
+{
+    metric_cache_data_t data[3];  /* mesh, area, basis */
+    std::list<metric_cache_key_t>::iterator lru;
+};
+
+struct fclaw2d_metric_cache
+{
+    std::list<metric_cache_key_t> lru;  /* Most recently used first */
+    std::map<metric_cache_key_t, metric_cache_entry> entries;
+};
+
+static FArrayBox fclaw2d_metric_patch_t::*const metric_cache_mesh[] =
+{
+    &fclaw2d_metric_patch_t::xp, &fclaw2d_metric_patch_t::yp, 
+    &fclaw2d_metric_patch_t::zp, &fclaw2d_metric_patch_t::xd, 
+    &fclaw2d_metric_patch_t::yd, &fclaw2d_metric_patch_t::zd, NULL
+};
+
+static FArrayBox fclaw2d_metric_patch_t::*const metric_cache_area[] =
+{
+    &fclaw2d_metric_patch_t::area, NULL
+};
+
+static FArrayBox fclaw2d_metric_patch_t::*const metric_cache_basis[] =
+{
+    &fclaw2d_metric_patch_t::xface_normals, &fclaw2d_metric_patch_t::yface_normals,
+    &fclaw2d_metric_patch_t::xface_tangents, &fclaw2d_metric_patch_t::yface_tangents,
+    &fclaw2d_metric_patch_t::edge_lengths, &fclaw2d_metric_patch_t::surf_normals,
+    &fclaw2d_metric_patch_t::curvature, NULL
+};
+
+static FArrayBox fclaw2d_metric_patch_t::*const *const metric_cache_fields[] =
+{
+    metric_cache_mesh, metric_cache_area, metric_cache_basis
+};
+
+static
+metric_cache_key_t metric_cache_key(fclaw2d_patch_t *patch, int blockno)
+{
+    int level = patch->level;
+    double scale = (double) (1 << level);
+    return std::make_tuple(blockno, level,
+                           (int) (patch->xlower*scale + 0.5),
+                           (int) (patch->ylower*scale + 0.5));
+}
+#endif
+
+/* Copy parts of the metric terms of a patch from the cache.  Returns the 
+   parts that were found. */
+static
+int metric_cache_load(fclaw2d_global_t *glob, fclaw2d_patch_t *patch,
+                      int blockno, int parts)
+{
+    int found = 0;
+#if PATCH_DIM == 2
+    fclaw2d_metric_vtable_t *metric_vt = fclaw2d_metric_vt(glob);
+    fclaw2d_metric_patch_t* mp = get_metric_patch(glob, patch);
+    metric_cache_key_t key = metric_cache_key(patch, blockno);
+    metric_cache_data_t data[3];
+
+    /* The cache is created by metric_cache_store, possibly on another
+       thread, so it is only looked at in the critical section.  Only the
+       lookup is done there; the terms are copied below. */
+#pragma omp critical(fclaw2d_metric_cache)
+    {
+        fclaw2d_metric_cache *cache = metric_vt->cache;
+        if (cache != NULL)
+        {
+            auto it = cache->entries.find(key);
+            if (it != cache->entries.end())
+            {
+                metric_cache_entry& entry = it->second;
+                cache->lru.splice(cache->lru.begin(), cache->lru, entry.lru);
+                for (int k = 0; k < 3; k++)
+                {
+                    if (parts & (1 << k))
+                    {
+                        data[k] = entry.data[k];
+                    }
+                }
+            }
+        }
+    }
+
+    for (int k = 0; k < 3; k++)
+    {
+        if (!data[k] || data[k]->empty())
+        {
+            continue;
+        }
+        if (k == 2 && mp->shared_basis != NULL)
+        {
+            continue;
+        }
+        size_t size = 0;
+        for (int i = 0; metric_cache_fields[k][i] != NULL; i++)
+        {
+            size += (mp->*metric_cache_fields[k][i]).size();
+        }
+        if (size != data[k]->size())
+        {
+            /* Stored for a patch with a different layout */
+            continue;
+        }
+        const double *src = data[k]->data();
+        for (int i = 0; metric_cache_fields[k][i] != NULL; i++)
+        {
+            FArrayBox& fbox = mp->*metric_cache_fields[k][i];
+            memcpy(fbox.dataPtr(), src, fbox.size()*sizeof(double));
+            src += fbox.size();
+        }
+        found |= 1 << k;
+    }
+#endif
+    return found;
+}
+
+/* Store parts of the metric terms of a patch in the cache */
+static
+void metric_cache_store(fclaw2d_global_t *glob, fclaw2d_patch_t *patch,
+                        int blockno, int parts)
+{
+#if PATCH_DIM == 2
+    const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+    if (fclaw_opt->metric_cache_size <= 0)
+    {
+        return;
+    }
+    fclaw2d_metric_vtable_t *metric_vt = fclaw2d_metric_vt(glob);
+    fclaw2d_metric_patch_t* mp = get_metric_patch(glob, patch);
+    if (mp->shared_basis != NULL)
+    {
+        /* Shared basis terms are computed once anyway */
+        parts &= ~METRIC_CACHE_BASIS;
+    }
+    metric_cache_key_t key = metric_cache_key(patch, blockno);
+
+    /* Copy the terms before entering the critical section */
+    metric_cache_data_t data[3];
+    for (int k = 0; k < 3; k++)
+    {
+        if (!(parts & (1 << k)))
+        {
+            continue;
+        }
+        std::shared_ptr<std::vector<double> > v =
+            std::make_shared<std::vector<double> >();
+        for (int i = 0; metric_cache_fields[k][i] != NULL; i++)
+        {
+            FArrayBox& fbox = mp->*metric_cache_fields[k][i];
+            const double *q = fbox.dataPtr();
+            v->insert(v->end(), q, q + fbox.size());
+        }
+        data[k] = v;
+    }
+
+    /* Replaced and dropped terms are freed after the critical section */
+    metric_cache_entry dropped;
+#pragma omp critical(fclaw2d_metric_cache)
+    {
+        if (metric_vt->cache == NULL)
+        {
+            metric_vt->cache = new fclaw2d_metric_cache;
+        }
+        fclaw2d_metric_cache *cache = metric_vt->cache;
+
+        auto it = cache->entries.find(key);
+        if (it == cache->entries.end())
+        {
+            if ((int) cache->entries.size() >= fclaw_opt->metric_cache_size)
+            {
+                auto last = cache->entries.find(cache->lru.back());
+                for (int k = 0; k < 3; k++)
+                {
+                    dropped.data[k].swap(last->second.data[k]);
+                }
+                cache->entries.erase(last);
+                cache->lru.pop_back();
+            }
+            cache->lru.push_front(key);
+            it = cache->entries.insert(std::make_pair(key, metric_cache_entry())).first;
+            it->second.lru = cache->lru.begin();
+        }
+        else
+        {
+            cache->lru.splice(cache->lru.begin(), cache->lru, it->second.lru);
+        }
+
+        metric_cache_entry& entry = it->second;
+        for (int k = 0; k < 3; k++)
+        {
+            if (data[k])
+            {
+                entry.data[k].swap(data[k]);
+            }
+        }
+    }
+#endif
+}
+
 /* ----------------------------- Creating/deleting patches ---------------------------- */
 
 fclaw2d_metric_patch_t* fclaw2d_metric_patch_new()
 {
     fclaw2d_metric_patch_t *mp = new fclaw2d_metric_patch_t;
+#if PATCH_DIM == 2
+    mp->shared_basis = NULL;
+#endif
     return mp;
 }
 
@@ -127,6 +462,8 @@ void fclaw3d_metric_patch_define(fclaw2d_global_t* glob,
     mp->zlower = zlower;
     mp->zupper = zupper;
     mp->dz = (mp->zupper - mp->zlower)/mp->mz;
+#else
+    mp->shared_basis = NULL;
 #endif    
 
     /* Set up area for storage - this is needed for ghost patches, 
@@ -239,6 +576,14 @@ void fclaw3d_metric_patch_define(fclaw2d_global_t* glob,
         mp->yd.define(box_d,1);
         mp->zd.define(box_d,1);
 
+        const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+        fclaw2d_map_context_t *cont = glob->cont;
+        if (fclaw_opt->share_metric && cont != NULL && FCLAW2D_MAP_IS_AFFINE(&cont))
+        {
+            metric_define_shared_basis(glob,mp,patch->level,box_p,box_d);
+            return;
+        }
+
         mp->surf_normals.define(box_p,3);
         mp->curvature.define(box_p,1);
 
@@ -347,7 +692,11 @@ void fclaw2d_metric_patch_compute_area (fclaw2d_global_t *glob,
     fclaw2d_metric_vtable_t *metric_vt = fclaw2d_metric_vt(glob);
 #if PATCH_DIM == 2
     FCLAW_ASSERT(metric_vt->compute_area);
-    metric_vt->compute_area(glob,patch,blockno,patchno);
+    if (metric_cache_load(glob,patch,blockno,METRIC_CACHE_AREA) == 0)
+    {
+        metric_vt->compute_area(glob,patch,blockno,patchno);
+        metric_cache_store(glob,patch,blockno,METRIC_CACHE_AREA);
+    }
 #elif PATCH_DIM == 3
     FCLAW_ASSERT(metric_vt->compute_volume);
     metric_vt->compute_volume(glob,patch,blockno,patchno);
@@ -363,8 +712,12 @@ void fclaw2d_metric_patch_build(fclaw2d_global_t* glob,
     fclaw2d_metric_vtable_t *metric_vt = fclaw2d_metric_vt(glob);
     FCLAW_ASSERT(metric_vt != NULL);
 
+    int all = METRIC_CACHE_MESH | METRIC_CACHE_AREA | METRIC_CACHE_BASIS;
+    int found = metric_cache_load(glob,patch,blockno,all);
+
     /* Compute (xp,yp,zp) and (xd,yd,zd) */
-    metric_vt->compute_mesh(glob,patch,blockno,patchno);
+    if (!(found & METRIC_CACHE_MESH))
+        metric_vt->compute_mesh(glob,patch,blockno,patchno);
 
     /* Compute areas/volumes ($$$) from scratch. 
        Note : These are all computed on finest level 
@@ -372,20 +725,22 @@ void fclaw2d_metric_patch_build(fclaw2d_global_t* glob,
        required from geometric consistency */
 #if PATCH_DIM == 2    
     /* Compute 2d patch areas */
-    metric_vt->compute_area(glob,patch,blockno,patchno);
+    if (!(found & METRIC_CACHE_AREA))
+        metric_vt->compute_area(glob,patch,blockno,patchno);
 #elif PATCH_DIM == 3    
     /* Compute 3d volumes and 2d face areas */
     metric_vt->compute_volume(glob,patch,blockno,patchno);
 #endif
-    if (metric_vt->compute_basis != NULL)
-    {
-        /* In 2d : Surface normals, tangents, edge lengths, 
-           surface normals and curvature. 
+    /* In 2d : Surface normals, tangents, edge lengths, 
+       surface normals and curvature. 
 
-           In 3d : Rotation matrix at each face. 
-        */
-        metric_vt->compute_basis(glob,patch,blockno,patchno);
-    }
+       In 3d : Rotation matrix at each face. 
+    */
+    if (!(found & METRIC_CACHE_BASIS))
+        metric_compute_basis(glob,patch,blockno,patchno);
+
+    if (found != all)
+        metric_cache_store(glob,patch,blockno,all & ~found);
 }
 
 
@@ -401,8 +756,12 @@ void fclaw2d_metric_patch_build_from_fine(fclaw2d_global_t *glob,
        volumes and in 3d, face areas */
     fclaw2d_metric_vtable_t *metric_vt = fclaw2d_metric_vt(glob);
 
+    int parts = METRIC_CACHE_MESH | METRIC_CACHE_BASIS;
+    int found = metric_cache_load(glob,coarse_patch,blockno,parts);
+
     /* Compute xd,yd,zd, xp,yp,zp */
-    metric_vt->compute_mesh(glob,coarse_patch,blockno,coarse_patchno);
+    if (!(found & METRIC_CACHE_MESH))
+        metric_vt->compute_mesh(glob,coarse_patch,blockno,coarse_patchno);
 
     /* Compute areas/volumes by averaging from finer grids  */
 
@@ -410,16 +769,17 @@ void fclaw2d_metric_patch_build_from_fine(fclaw2d_global_t *glob,
                                   blockno, coarse_patchno, 
                                   fine0_patchno);
 
-    if (metric_vt->compute_basis != NULL)
-    {
-        /* In 2d : Surface normals and tangents at each face
-           In 3d : Rotation matrix for each face. 
+    /* In 2d : Surface normals and tangents at each face
+       In 3d : Rotation matrix for each face. 
 
-           Note : These are not averaged from finer grids, but are 
-           built from scratch here. 
-        */
-        metric_vt->compute_basis(glob,coarse_patch,blockno,coarse_patchno);        
-    }
+       Note : These are not averaged from finer grids, but are 
+       built from scratch here. 
+    */
+    if (!(found & METRIC_CACHE_BASIS))
+        metric_compute_basis(glob,coarse_patch,blockno,coarse_patchno);
+
+    if (found != parts)
+        metric_cache_store(glob,coarse_patch,blockno,parts & ~found);
 }
 
 
@@ -435,6 +795,10 @@ fclaw2d_metric_vtable_t* metric_vt_new()
 static
 void metric_vt_destroy(void* vt)
 {
+#if PATCH_DIM == 2
+    delete ((fclaw2d_metric_vtable_t*) vt)->shared;
+    delete ((fclaw2d_metric_vtable_t*) vt)->cache;
+#endif
     FCLAW_FREE (vt);
 }
 
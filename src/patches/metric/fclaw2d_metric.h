@@ -46,6 +46,8 @@ typedef struct fclaw2d_metric_vtable fclaw2d_metric_vtable_t;
 
 struct fclaw2d_global;
 struct fclaw2d_patch;
+struct fclaw2d_metric_shared;
+struct fclaw2d_metric_cache;
 
 /* --------------------------- Metric routines (typedefs) ----------------------------- */
 /**
@@ -360,6 +362,12 @@ struct fclaw2d_metric_vtable
 	/** Compute the surface normals */
 	fclaw2d_metric_fort_compute_surf_normals_t  fort_compute_surf_normals;
 
+	/** Basis terms shared among patches (option share_metric) */
+	struct fclaw2d_metric_shared *shared;
+
+	/** Metric terms of recently built patches (option metric_cache_size) */
+	struct fclaw2d_metric_cache *cache;
+
 	/** True if vtable has been set */
 	int is_set;
 };
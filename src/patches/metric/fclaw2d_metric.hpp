@@ -32,6 +32,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <fclaw2d_farraybox.hpp>     /* Needed for FArray box used to store metric data */
 
+struct fclaw2d_metric_shared_basis;
+
 /**
  * @brief Struct for patch metric data
  */
@@ -90,6 +92,9 @@ struct fclaw2d_metric_patch_t
     FArrayBox area;
     /** curvature of each cell */
     FArrayBox curvature;
+
+    /** Basis terms shared with other patches (option share_metric), or NULL */
+    struct fclaw2d_metric_shared_basis *shared_basis;
 };
 
 /**
@@ -255,22 +255,23 @@ void clawpack46_setaux(fclaw2d_global_t *glob,
 	CLAWPACK46_UNSET_BLOCK();
 }
 
-/* This is called from the single_step callback. and is of type 'flaw_single_step_t' */
+/* Patch-independent data needed by the step routine */
+typedef struct clawpack46_step_context
+{
+	fc2d_clawpack46_vtable_t *claw46_vt;
+	const fclaw_options_t *fclaw_opt;
+	const fc2d_clawpack46_options_t *clawpack_options;
+} clawpack46_step_context_t;
+
 static
-double clawpack46_step2(fclaw2d_global_t *glob,
-						fclaw2d_patch_t *patch,
-						int blockno,
-						int patchno,
-						double t,
-						double dt)
+void clawpack46_step_context_init(fclaw2d_global_t *glob,
+								  clawpack46_step_context_t *ctx)
 {
 	fc2d_clawpack46_vtable_t*  claw46_vt = fc2d_clawpack46_vt(glob);
-	const fclaw_options_t* fclaw_opt = fclaw2d_get_options(glob);
 	const fc2d_clawpack46_options_t* clawpack_options;
 
 	clawpack_options = fc2d_clawpack46_get_options(glob);
 
-
 	if (clawpack_options->use_fwaves)
 	{
 		FCLAW_ASSERT(claw46_vt->fort_rpn2fw != NULL);
@@ -284,7 +285,29 @@ double clawpack46_step2(fclaw2d_global_t *glob,
 			FCLAW_ASSERT(claw46_vt->fort_rpt2 != NULL);
 	}
 
+	if (claw46_vt->flux2 == NULL)
+	{
+		claw46_vt->flux2 = (clawpack_options->use_fwaves != 0) ? &CLAWPACK46_FLUX2FW : 
+		                       &CLAWPACK46_FLUX2;	
+	}
 
+	ctx->claw46_vt = claw46_vt;
+	ctx->fclaw_opt = fclaw2d_get_options(glob);
+	ctx->clawpack_options = clawpack_options;
+}
+
+static
+double clawpack46_step2(fclaw2d_global_t *glob,
+						const clawpack46_step_context_t *ctx,
+						fclaw2d_patch_t *patch,
+						int blockno,
+						int patchno,
+						double t,
+						double dt)
+{
+	fc2d_clawpack46_vtable_t*  claw46_vt = ctx->claw46_vt;
+	const fclaw_options_t* fclaw_opt = ctx->fclaw_opt;
+	const fc2d_clawpack46_options_t* clawpack_options = ctx->clawpack_options;
 
 	int level = patch->level;
 
@@ -317,10 +340,10 @@ double clawpack46_step2(fclaw2d_global_t *glob,
 	if (fclaw_opt->time_sync && fclaw_opt->flux_correction)
 	{
 		FCLAW_ASSERT(claw46_vt->fort_rpn2_cons != NULL);
-		double *qvec          = FCLAW_ALLOC(double, meqn);
-		double *auxvec_center = FCLAW_ALLOC(double, maux);
-		double *auxvec_edge   = FCLAW_ALLOC(double, maux);
-		double *flux          = FCLAW_ALLOC(double, meqn);     /* f(qr) - f(ql) = amdq+apdq */
+		double *qvec          = fclaw2d_global_get_scratch(glob, 0, meqn);
+		double *auxvec_center = fclaw2d_global_get_scratch(glob, 1, maux);
+		double *auxvec_edge   = fclaw2d_global_get_scratch(glob, 2, maux);
+		double *flux          = fclaw2d_global_get_scratch(glob, 3, meqn);     /* f(qr) - f(ql) = amdq+apdq */
 
 		CLAWPACK46_TIME_SYNC_STORE_FLUX(&mx,&my,&mbc,&meqn,&maux,
 		                                &blockno,&patchno, &dt,
@@ -333,32 +356,23 @@ double clawpack46_step2(fclaw2d_global_t *glob,
 										cr->edge_fluxes[2],cr->edge_fluxes[3],
 										claw46_vt->fort_rpn2_cons,
 										qvec,auxvec_center,auxvec_edge,flux);
-
-		FCLAW_FREE(qvec);
-		FCLAW_FREE(auxvec_center);
-		FCLAW_FREE(auxvec_edge);
-		FCLAW_FREE(flux);
 	}
 
 
 
+	/* Work arrays are borrowed from per-thread scratch space; they are
+	   the same size for every patch and need not be freed here. */
 	int mwork = (maxm+2*mbc)*(12*meqn + (meqn+1)*mwaves + 3*maux + 2);
-	double* work = FCLAW_ALLOC(double,mwork);
+	double* work = fclaw2d_global_get_scratch(glob, 0, mwork);
 
 	int size = meqn*(mx+2*mbc)*(my+2*mbc);
-	double* fp = FCLAW_ALLOC(double,size);
-	double* fm = FCLAW_ALLOC(double,size);
-	double* gp = FCLAW_ALLOC(double,size);
-	double* gm = FCLAW_ALLOC(double,size);
+	double* fp = fclaw2d_global_get_scratch(glob, 1, size);
+	double* fm = fclaw2d_global_get_scratch(glob, 2, size);
+	double* gp = fclaw2d_global_get_scratch(glob, 3, size);
+	double* gm = fclaw2d_global_get_scratch(glob, 4, size);
 
 	int ierror = 0;
 
-	if (claw46_vt->flux2 == NULL)
-	{
-		claw46_vt->flux2 = (clawpack_options->use_fwaves != 0) ? &CLAWPACK46_FLUX2FW : 
-		                       &CLAWPACK46_FLUX2;	
-	}
-
 	/* NOTE: qold will be overwritten in this step */
 	CLAWPACK46_SET_BLOCK(&blockno);
 	CLAWPACK46_STEP2_WRAP(&maxm, &meqn, &maux, &mbc, clawpack_options->method,
@@ -389,13 +403,6 @@ double clawpack46_step2(fclaw2d_global_t *glob,
 		                                      cr->gm[0],cr->gm[1]);
 	}		
 
-
-	FCLAW_FREE(fp);
-	FCLAW_FREE(fm);
-	FCLAW_FREE(gp);
-	FCLAW_FREE(gm);
-	FCLAW_FREE(work);
-
 	return cflgrid;
 }
 
@@ -408,11 +415,10 @@ double clawpack46_update(fclaw2d_global_t *glob,
                          double dt, 
                          void* user)
 {
-    fc2d_clawpack46_vtable_t*  claw46_vt = fc2d_clawpack46_vt(glob);
-
-    const fc2d_clawpack46_options_t* clawpack_options;
-    clawpack_options = fc2d_clawpack46_get_options(glob);
+    clawpack46_step_context_t ctx;
+    clawpack46_step_context_init(glob,&ctx);
 
+    fc2d_clawpack46_vtable_t*  claw46_vt = ctx.claw46_vt;
     if (claw46_vt->b4step2 != NULL)
     {
         fclaw2d_timer_start_threadsafe(&glob->timers[FCLAW2D_TIMER_ADVANCE_B4STEP2]);               
@@ -424,26 +430,34 @@ double clawpack46_update(fclaw2d_global_t *glob,
         fclaw2d_timer_stop_threadsafe(&glob->timers[FCLAW2D_TIMER_ADVANCE_B4STEP2]);               
     }
 
+    int src = ctx.clawpack_options->src_term > 0 && claw46_vt->src2 != NULL;
+    int measure = ctx.fclaw_opt->partition_cost == 1;  /* update time as patch cost */
+
+    double start = measure ? fclaw2d_timer_wtime() : 0;
     fclaw2d_timer_start_threadsafe(&glob->timers[FCLAW2D_TIMER_ADVANCE_STEP2]);       
 
-    double maxcfl = clawpack46_step2(glob,
+    double maxcfl = clawpack46_step2(glob,&ctx,
                                      patch,
                                      blockno,
                                      patchno,t,dt);
 
     fclaw2d_timer_stop_threadsafe(&glob->timers[FCLAW2D_TIMER_ADVANCE_STEP2]);       
 
-    if (clawpack_options->src_term > 0 && claw46_vt->src2 != NULL)
+    if (src)
     {
         claw46_vt->src2(glob,
                         patch,
                         blockno,
                         patchno,t,dt);
     }
+    if (measure)
+    {
+        fclaw2d_patch_add_cost(glob,patch,fclaw2d_timer_wtime() - start);
+    }
+    fclaw2d_clawpatch_tag_after_update(glob,patch,blockno,t,dt);
     return maxcfl;
 }
 
-
 /* ---------------------------------- Output functions -------------------------------- */
 
 static
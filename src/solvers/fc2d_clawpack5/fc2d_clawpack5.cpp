@@ -239,28 +239,43 @@ void clawpack5_bc2(fclaw2d_global_t *glob,
 }
 
 
-/* This is called from the single_step callback. and is of type 'flaw_single_step_t' */
+/* Patch-independent data needed by the step routine */
+typedef struct clawpack5_step_context
+{
+    fc2d_clawpack5_vtable_t *claw5_vt;
+    const fclaw_options_t *fclaw_opt;
+    const fc2d_clawpack5_options_t *clawpack_options;
+} clawpack5_step_context_t;
+
+static
+void clawpack5_step_context_init(fclaw2d_global_t *glob,
+                                 clawpack5_step_context_t *ctx)
+{
+    ctx->claw5_vt = fc2d_clawpack5_vt(glob);
+    ctx->fclaw_opt = fclaw2d_get_options(glob);
+    ctx->clawpack_options = fc2d_clawpack5_get_options(glob);
+
+    FCLAW_ASSERT(ctx->claw5_vt->fort_rpn2 != NULL);
+    FCLAW_ASSERT(ctx->claw5_vt->fort_rpt2 != NULL);
+}
+
 static
 double clawpack5_step2(fclaw2d_global_t *glob,
+                       const clawpack5_step_context_t *ctx,
                        fclaw2d_patch_t *this_patch,
                        int this_block_idx,
                        int this_patch_idx,
                        double t,
                        double dt)
 {
-    fc2d_clawpack5_vtable_t*  claw5_vt = fc2d_clawpack5_vt(glob);
+    fc2d_clawpack5_vtable_t*  claw5_vt = ctx->claw5_vt;
 
-    fc2d_clawpack5_options_t* clawpack_options;
+    const fc2d_clawpack5_options_t* clawpack_options = ctx->clawpack_options;
     int level;
     double *qold, *aux;
     int mx, my, meqn, maux, mbc;
     double xlower, ylower, dx,dy;
 
-    FCLAW_ASSERT(claw5_vt->fort_rpn2 != NULL);
-    FCLAW_ASSERT(claw5_vt->fort_rpt2 != NULL);
-
-    clawpack_options = fc2d_clawpack5_get_options(glob);
-
     level = this_patch->level;
 
     fclaw2d_clawpatch_aux_data(glob,this_patch,&aux,&maux);
@@ -282,14 +297,14 @@ double clawpack5_step2(fclaw2d_global_t *glob,
           fclaw2d_clawpatch_get_registers(glob,this_patch);
 
     /* Evaluate fluxes needed in correction terms */
-    const fclaw_options_t* fclaw_opt = fclaw2d_get_options(glob);
+    const fclaw_options_t* fclaw_opt = ctx->fclaw_opt;
     if (fclaw_opt->time_sync && fclaw_opt->flux_correction)
     {
         FCLAW_ASSERT(claw5_vt->fort_rpn2_cons != NULL);
-        double *qvec          = FCLAW_ALLOC(double, meqn);
-        double *auxvec_center = FCLAW_ALLOC(double, maux);
-        double *auxvec_edge   = FCLAW_ALLOC(double, maux);
-        double *flux          = FCLAW_ALLOC(double, meqn);     /* f(qr) - f(ql) = amdq+apdq */
+        double *qvec          = fclaw2d_global_get_scratch(glob, 0, meqn);
+        double *auxvec_center = fclaw2d_global_get_scratch(glob, 1, maux);
+        double *auxvec_edge   = fclaw2d_global_get_scratch(glob, 2, maux);
+        double *flux          = fclaw2d_global_get_scratch(glob, 3, meqn);     /* f(qr) - f(ql) = amdq+apdq */
 
 #if 1
         CLAWPACK5_TIME_SYNC_STORE_FLUX(&mx,&my,&mbc,&meqn,&maux,
@@ -304,20 +319,17 @@ double clawpack5_step2(fclaw2d_global_t *glob,
                                        claw5_vt->fort_rpn2_cons,
                                        qvec,auxvec_center,auxvec_edge,flux);
 #endif
-        FCLAW_FREE(qvec);
-        FCLAW_FREE(auxvec_center);
-        FCLAW_FREE(auxvec_edge);
-        FCLAW_FREE(flux);
     }
 
+    /* Work arrays are borrowed from per-thread scratch space */
     int mwork = (maxm+2*mbc)*(12*meqn + (meqn+1)*mwaves + 3*maux + 2);
-    double* work = new double[mwork];
+    double* work = fclaw2d_global_get_scratch(glob, 0, mwork);
 
     int size = meqn*(mx+2*mbc)*(my+2*mbc);
-    double* fp = new double[size];
-    double* fm = new double[size];
-    double* gp = new double[size];
-    double* gm = new double[size];
+    double* fp = fclaw2d_global_get_scratch(glob, 1, size);
+    double* fm = fclaw2d_global_get_scratch(glob, 2, size);
+    double* gp = fclaw2d_global_get_scratch(glob, 3, size);
+    double* gm = fclaw2d_global_get_scratch(glob, 4, size);
 
 
     int ierror = 0;
@@ -353,13 +365,6 @@ double clawpack5_step2(fclaw2d_global_t *glob,
                                               cr->gm[0],cr->gm[1]);
     }       
 
-    delete [] fp;
-    delete [] fm;
-    delete [] gp;
-    delete [] gm;
-
-    delete [] work;
-
     return cflgrid;
 }
 
@@ -372,35 +377,45 @@ double clawpack5_update(fclaw2d_global_t *glob,
                         double dt,
                         void* user)
 {    
-    fc2d_clawpack5_vtable_t*  claw5_vt = fc2d_clawpack5_vt(glob);
-
-    const fc2d_clawpack5_options_t* clawpack_options;
-    clawpack_options = fc2d_clawpack5_get_options(glob);
+    clawpack5_step_context_t ctx;
+    clawpack5_step_context_init(glob,&ctx);
 
+    fc2d_clawpack5_vtable_t*  claw5_vt = ctx.claw5_vt;
     if (claw5_vt->b4step2 != NULL)
     {
-        fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_ADVANCE_B4STEP2]);       
+        fclaw2d_timer_start_threadsafe (&glob->timers[FCLAW2D_TIMER_ADVANCE_B4STEP2]);       
         claw5_vt->b4step2(glob,
                           this_patch,
                           this_block_idx,
                           this_patch_idx,t,dt);
-        fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_ADVANCE_B4STEP2]);       
+        fclaw2d_timer_stop_threadsafe (&glob->timers[FCLAW2D_TIMER_ADVANCE_B4STEP2]);       
     }
 
-    fclaw2d_timer_start (&glob->timers[FCLAW2D_TIMER_ADVANCE_STEP2]);       
-    double maxcfl = clawpack5_step2(glob,
+    int src = ctx.clawpack_options->src_term > 0 && claw5_vt->src2 != NULL;
+    int measure = ctx.fclaw_opt->partition_cost == 1;  /* update time as patch cost */
+
+    double start = measure ? fclaw2d_timer_wtime() : 0;
+    fclaw2d_timer_start_threadsafe (&glob->timers[FCLAW2D_TIMER_ADVANCE_STEP2]);       
+
+    double maxcfl = clawpack5_step2(glob,&ctx,
                                     this_patch,
                                     this_block_idx,
                                     this_patch_idx,t,dt);
-    fclaw2d_timer_stop (&glob->timers[FCLAW2D_TIMER_ADVANCE_STEP2]);       
 
-    if (clawpack_options->src_term > 0 && claw5_vt->src2 != NULL)
+    fclaw2d_timer_stop_threadsafe (&glob->timers[FCLAW2D_TIMER_ADVANCE_STEP2]);       
+
+    if (src)
     {
         claw5_vt->src2(glob,
                        this_patch,
                        this_block_idx,
                        this_patch_idx,t,dt);
     }
+    if (measure)
+    {
+        fclaw2d_patch_add_cost(glob,this_patch,fclaw2d_timer_wtime() - start);
+    }
+    fclaw2d_clawpatch_tag_after_update(glob,this_patch,this_block_idx,t,dt);
     return maxcfl;
 }
 
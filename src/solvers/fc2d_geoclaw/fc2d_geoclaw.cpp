@@ -302,17 +302,17 @@ double geoclaw_step2(fclaw2d_global_t *glob,
     double *qold;
     fclaw2d_clawpatch_soln_data(glob,patch,&qold,&meqn);
 
-    /* Allocate work arrays */
+    /* Borrow work arrays from per-thread scratch space */
     int mwaves = geoclaw_options->mwaves;
     int maxm = fmax(mx,my);
     int mwork = (maxm+2*mbc)*(12*meqn + (meqn+1)*mwaves + 3*maux + 2);
-    double* work = new double[mwork];
+    double* work = fclaw2d_global_get_scratch(glob, 0, mwork);
 
     int size = meqn*(mx+2*mbc)*(my+2*mbc);
-    double* fp = new double[size];
-    double* fm = new double[size];
-    double* gp = new double[size];
-    double* gm = new double[size];
+    double* fp = fclaw2d_global_get_scratch(glob, 1, size);
+    double* fm = fclaw2d_global_get_scratch(glob, 2, size);
+    double* gp = fclaw2d_global_get_scratch(glob, 3, size);
+    double* gm = fclaw2d_global_get_scratch(glob, 4, size);
 
     int* block_corner_count = fclaw2d_patch_block_corner_count(glob,patch);
 
@@ -327,13 +327,6 @@ double geoclaw_step2(fclaw2d_global_t *glob,
                        geoclaw_vt->rpn2, geoclaw_vt->rpt2,
                        block_corner_count);
 
-    delete [] fp;
-    delete [] fm;
-    delete [] gp;
-    delete [] gm;
-
-    delete [] work;
-
     return cflgrid;
 }
 
@@ -363,6 +356,10 @@ double geoclaw_update(fclaw2d_global_t *glob,
                     blockno,
                     patchno,t,dt);
 
+    const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+    int measure = fclaw_opt->partition_cost == 1;  /* update time as patch cost */
+    double start = measure ? fclaw2d_timer_wtime() : 0;
+
     double maxcfl = geoclaw_step2(glob,
                                   patch,
                                   blockno,
@@ -376,6 +373,10 @@ double geoclaw_update(fclaw2d_global_t *glob,
                      blockno,
                      patchno,t,dt);
     }
+    if (measure)
+    {
+        fclaw2d_patch_add_cost(glob,patch,fclaw2d_timer_wtime() - start);
+    }
 
     return maxcfl;
 }
@@ -842,6 +843,15 @@ void fc2d_geoclaw_solver_initialize(fclaw2d_global_t* glob)
         fclaw_opt->ghost_patch_pack_numextrafields = clawpatch_opt->maux;
     }
 
+    /* Refinement regions depend on the time of the regrid, and the tags
+       are computed by geoclaw_patch_tag4refinement, not clawpatch */
+    if (fclaw_opt->tag_in_update)
+    {
+        fclaw_global_essentialf("fc2d_geoclaw : tag-in-update is not supported; " \
+                                "tagging at the regrid instead.\n");
+        fclaw_opt->tag_in_update = 0;
+    }
+
     int claw_version = 5;
     fclaw2d_clawpatch_vtable_initialize(glob, claw_version);
     
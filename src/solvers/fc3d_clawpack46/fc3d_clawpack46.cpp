@@ -341,15 +341,16 @@ double clawpack46_step3(fclaw2d_global_t *glob,
 
 	int msize = maxm + 2*mbc;
 	int mwork = msize*(46*meqn + (meqn+1)*mwaves + 9*maux + 3);
-	double* work = FCLAW_ALLOC(double,mwork);
+	double* work = fclaw2d_global_get_scratch(glob, 0, mwork);
 
+	/* Work arrays are borrowed from per-thread scratch space */
 	int size = meqn*(mx+2*mbc)*(my+2*mbc)*(mz + 2*mbc);
-	double* fp = FCLAW_ALLOC(double,size);
-	double* fm = FCLAW_ALLOC(double,size);
-	double* gp = FCLAW_ALLOC(double,size);
-	double* gm = FCLAW_ALLOC(double,size);
-	double* hp = FCLAW_ALLOC(double,size);
-	double* hm = FCLAW_ALLOC(double,size);
+	double* fp = fclaw2d_global_get_scratch(glob, 1, size);
+	double* fm = fclaw2d_global_get_scratch(glob, 2, size);
+	double* gp = fclaw2d_global_get_scratch(glob, 3, size);
+	double* gm = fclaw2d_global_get_scratch(glob, 4, size);
+	double* hp = fclaw2d_global_get_scratch(glob, 5, size);
+	double* hm = fclaw2d_global_get_scratch(glob, 6, size);
 
 	int ierror = 0;
 	int* block_corner_count = fclaw2d_patch_block_corner_count(glob,patch);
@@ -396,14 +397,6 @@ double clawpack46_step3(fclaw2d_global_t *glob,
 #endif			
 
 
-	FCLAW_FREE(fp);
-	FCLAW_FREE(fm);
-	FCLAW_FREE(gp);
-	FCLAW_FREE(gm);
-	FCLAW_FREE(hp);
-	FCLAW_FREE(hm);
-	FCLAW_FREE(work);
-
 	return cflgrid;
 }
 
@@ -429,6 +422,10 @@ double clawpack46_update(fclaw2d_global_t *glob,
         fclaw2d_timer_stop_threadsafe(&glob->timers[FCLAW2D_TIMER_ADVANCE_B4STEP2]);               
     }
 
+    /* update time as patch cost */
+    const fclaw_options_t* fclaw_opt = fclaw2d_get_options(glob);
+    double start = fclaw_opt->partition_cost == 1 ? fclaw2d_timer_wtime() : 0;
+
     fclaw2d_timer_start_threadsafe(&glob->timers[FCLAW2D_TIMER_ADVANCE_STEP2]);       
 
     double maxcfl = clawpack46_step3(glob,
@@ -446,6 +443,11 @@ double clawpack46_update(fclaw2d_global_t *glob,
                         blockno,
                         patchno,t,dt);
     }
+    if (fclaw_opt->partition_cost == 1)
+    {
+        fclaw2d_patch_add_cost(glob,patch,fclaw2d_timer_wtime() - start);
+    }
+    fclaw3dx_clawpatch_tag_after_update(glob,patch,blockno,t,dt);
     return maxcfl;
 }
 
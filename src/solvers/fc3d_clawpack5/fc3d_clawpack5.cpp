@@ -26,6 +26,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <fclaw2d_global.h>
 
 #include <fclaw2d_forestclaw.h>
+#include <fclaw2d_options.h>
+#include <fclaw2d_patch.h>
 #include <fclaw_clawpatch3.hpp>
 #include <fclaw2d_clawpatch.hpp>
 
@@ -420,13 +422,13 @@ double fc3d_clawpack5_step2(fclaw2d_global_t *glob,
     double cflgrid = 0.0;
 
     int mwork = (maxm+2*mbc)*(12*meqn + (meqn+1)*mwaves + 3*maux + 2);
-    double* work = new double[mwork];
+    double* work = fclaw2d_global_get_scratch(glob, 0, mwork);
 
     int size = meqn*(mx+2*mbc)*(my+2*mbc);
-    double* fp = new double[size];
-    double* fm = new double[size];
-    double* gp = new double[size];
-    double* gm = new double[size];
+    double* fp = fclaw2d_global_get_scratch(glob, 1, size);
+    double* fm = fclaw2d_global_get_scratch(glob, 2, size);
+    double* gp = fclaw2d_global_get_scratch(glob, 3, size);
+    double* gm = fclaw2d_global_get_scratch(glob, 4, size);
 
 
     int ierror = 0;
@@ -452,13 +454,6 @@ double fc3d_clawpack5_step2(fclaw2d_global_t *glob,
     }
 
 
-    delete [] fp;
-    delete [] fm;
-    delete [] gp;
-    delete [] gm;
-
-    delete [] work;
-
     return cflgrid;
 }
 
@@ -478,6 +473,10 @@ double fc3d_clawpack5_update(fclaw2d_global_t *glob,
                                this_block_idx,
                                this_patch_idx,t,dt);
     }
+    const fclaw_options_t *fclaw_opt = fclaw2d_get_options(glob);
+    int measure = fclaw_opt->partition_cost == 1;  /* update time as patch cost */
+    double start = measure ? fclaw2d_timer_wtime() : 0;
+
     double maxcfl = fc3d_clawpack5_step2(glob,
                                          this_patch,
                                          this_block_idx,
@@ -489,6 +488,10 @@ double fc3d_clawpack5_update(fclaw2d_global_t *glob,
                              this_block_idx,
                              this_patch_idx,t,dt);
     }
+    if (measure)
+    {
+        fclaw2d_patch_add_cost(glob,this_patch,fclaw2d_timer_wtime() - start);
+    }
     return maxcfl;
 }
 